@@ -0,0 +1,49 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 FragPos;
+in vec3 Normal;
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec3 lightPos;
+};
+
+#include "noise/baked.glsl"
+
+// Add uniforms
+layout (std140) uniform Material {
+    vec3 baseColor;
+    float noiseScale;
+    float noiseAmplitude;
+};
+
+void main() {
+    // Generate noise with octaves
+    float noiseValue = sampleBakedNoise(FragPos).r * noiseAmplitude + (1.0 - noiseAmplitude);
+    vec3 objectColor = baseColor * noiseValue;
+    
+    // Lighting calculations
+    vec3 norm = normalize(Normal);
+    vec3 lightDir = normalize(lightPos - FragPos);
+    
+    // Ambient
+    float ambientStrength = 0.2;
+    vec3 ambient = ambientStrength * objectColor;
+    
+    // Diffuse
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = diff * objectColor;
+    
+    // Specular
+    float specularStrength = 0.5;
+    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
+    vec3 specular = specularStrength * spec * vec3(1.0);
+    
+    vec3 result = ambient + diffuse + specular;
+    FragColor = vec4(result, 1.0);
+} 
\ No newline at end of file
@@ -0,0 +1,53 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 FragPos;
+in vec3 Normal;
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec3 lightPos;
+};
+
+#include "noise/baked.glsl"
+
+// Uniforms for noise and appearance
+layout (std140) uniform Material {
+    vec3 baseColor;
+    float noiseScale;
+    float noiseIntensity;
+    float minAlpha;
+    float maxAlpha;
+};
+
+void main() {
+    // Generate noise
+    float noiseValue = sampleBakedNoise(FragPos).r * 0.5 + 0.5;
+    
+    // Calculate alpha based on noise
+    float alpha = mix(minAlpha, maxAlpha, noiseValue);
+    
+    // Lighting calculations
+    vec3 norm = normalize(Normal);
+    vec3 lightDir = normalize(lightPos - FragPos);
+    
+    // Ambient
+    float ambientStrength = 0.3;
+    vec3 ambient = ambientStrength * baseColor;
+    
+    // Diffuse
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = diff * baseColor;
+    
+    // Specular
+    float specularStrength = 0.5;
+    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
+    vec3 specular = specularStrength * spec * vec3(1.0);
+    
+    vec3 result = ambient + diffuse + specular;
+    FragColor = vec4(result, alpha);
+} 
\ No newline at end of file
@@ -0,0 +1,6 @@
+#version 330 core
+
+// Depth-only pass: no colour output, the fixed-function depth write is all
+// that is needed
+void main() {
+}
@@ -0,0 +1,56 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 FragPos;
+in vec3 Normal;
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec3 lightPos;
+};
+
+#include "noise/baked.glsl"
+
+// Add uniforms
+layout (std140) uniform Material {
+    vec3 baseColor1;
+    float noiseTurbulence;
+    vec3 baseColor2;
+    float noiseGlow;
+    float colorMix;
+};
+
+void main() {
+    // Generate turbulent noise
+    float noiseValue = sampleBakedNoise(FragPos).r;
+    
+    // Create fire-like color gradient
+    vec3 objectColor = mix(baseColor1, baseColor2, noiseValue * colorMix);
+    
+    // Lighting calculations
+    vec3 norm = normalize(Normal);
+    vec3 lightDir = normalize(lightPos - FragPos);
+    
+    // Ambient
+    float ambientStrength = 0.2;
+    vec3 ambient = ambientStrength * objectColor;
+    
+    // Diffuse
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = diff * objectColor;
+    
+    // Specular
+    float specularStrength = 0.5;
+    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
+    vec3 specular = specularStrength * spec * vec3(1.0);
+    
+    // Add some emission for a fire-like glow
+    vec3 emission = objectColor * noiseValue * noiseGlow;
+    
+    vec3 result = ambient + diffuse + specular + emission;
+    FragColor = vec4(result, 1.0);
+} 
\ No newline at end of file
@@ -4,38 +4,14 @@ out vec4 FragColor;
 in vec3 FragPos;
 in vec3 Normal;
 
-uniform vec3 lightPos;
-uniform vec3 viewPos;
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec3 lightPos;
+};
 
-// Hash function for cellular noise
-vec3 hash3(vec3 p) {
-    p = vec3(dot(p,vec3(127.1,311.7, 74.7)),
-             dot(p,vec3(269.5,183.3,246.1)),
-             dot(p,vec3(113.5,271.9,124.6)));
-    return -1.0 + 2.0 * fract(sin(p)*43758.5453123);
-}
-
-// Cellular (Worley) noise
-float cellular(vec3 p) {
-    vec3 i_p = floor(p);
-    vec3 f_p = fract(p);
-    
-    float min_dist = 1.0;
-    
-    // Search neighboring cells
-    for(int k=-1; k<=1; k++)
-    for(int j=-1; j<=1; j++)
-    for(int i=-1; i<=1; i++) {
-        vec3 neighbor = vec3(float(i), float(j), float(k));
-        vec3 point = hash3(i_p + neighbor);
-        point = 0.5 + 0.5 * sin(point * 6.2831853); // Animate points
-        vec3 diff = neighbor + point - f_p;
-        float dist = length(diff);
-        min_dist = min(min_dist, dist);
-    }
-    
-    return min_dist;
-}
+#include "noise/cellular.glsl"
 
 // Enhanced cellular noise with multiple layers
 float enhancedCellular(vec3 p, float scale, float intensity) {
@@ -46,12 +22,25 @@ float enhancedCellular(vec3 p, float scale, float intensity) {
     return mix(n, n2, intensity);
 }
 
-uniform float noiseScale;
-uniform float noiseIntensity;
-uniform vec3 baseColor1;
-uniform vec3 baseColor2;
-uniform float edgeThreshold;
-uniform float glowStrength;
+#ifdef INSTANCED
+// The same Material block, one per instance (see instancing.glsl)
+flat in uvec4 InstanceMaterial[3];
+#define baseColor1 uintBitsToFloat(InstanceMaterial[0].xyz)
+#define noiseScale uintBitsToFloat(InstanceMaterial[0].w)
+#define baseColor2 uintBitsToFloat(InstanceMaterial[1].xyz)
+#define noiseIntensity uintBitsToFloat(InstanceMaterial[1].w)
+#define edgeThreshold uintBitsToFloat(InstanceMaterial[2].x)
+#define glowStrength uintBitsToFloat(InstanceMaterial[2].y)
+#else
+layout (std140) uniform Material {
+    vec3 baseColor1;
+    float noiseScale;
+    vec3 baseColor2;
+    float noiseIntensity;
+    float edgeThreshold;
+    float glowStrength;
+};
+#endif
 
 void main() {
     // Generate cellular noise
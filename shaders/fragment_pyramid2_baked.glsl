@@ -0,0 +1,61 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 FragPos;
+in vec3 Normal;
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec3 lightPos;
+};
+
+#include "noise/baked.glsl"
+
+layout (std140) uniform Material {
+    vec3 baseColor1;
+    float noiseScale;
+    vec3 baseColor2;
+    float noiseIntensity;
+    float edgeThreshold;
+    float glowStrength;
+};
+
+void main() {
+    // Generate cellular noise
+    // Both cellular layers are baked, the mix stays live
+    vec2 cells = sampleBakedNoise(FragPos).rg;
+    float noise = mix(cells.x, cells.y, noiseIntensity);
+    
+    // Create cell edges effect
+    float edge = 1.0 - smoothstep(0.0, edgeThreshold, noise);
+    
+    // Mix colors based on noise
+    vec3 cellColor = mix(baseColor1, baseColor2, noise);
+    vec3 edgeColor = vec3(1.0); // White edges
+    vec3 finalColor = mix(cellColor, edgeColor, edge);
+    
+    // Basic lighting
+    vec3 norm = normalize(Normal);
+    vec3 lightDir = normalize(lightPos - FragPos);
+    float diff = max(dot(norm, lightDir), 0.0);
+    
+    // Ambient
+    vec3 ambient = 0.3 * finalColor;
+    
+    // Diffuse
+    vec3 diffuse = diff * finalColor;
+    
+    // Specular
+    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
+    vec3 specular = 0.5 * spec * vec3(1.0);
+    
+    // Add glow to edges
+    vec3 glow = edge * glowStrength * baseColor2;
+    
+    vec3 result = ambient + diffuse + specular + glow;
+    FragColor = vec4(result, 1.0);
+} 
\ No newline at end of file
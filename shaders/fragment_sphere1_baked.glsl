@@ -0,0 +1,48 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 FragPos;
+in vec3 Normal;
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec3 lightPos;
+};
+
+#include "noise/baked.glsl"
+
+// Add uniforms
+layout (std140) uniform Material {
+    vec3 baseColor;
+    float noiseScale;
+    float noiseOffset;
+    float noiseIntensity;
+};
+
+void main() {
+    // Base color with noise
+    float noiseValue = sampleBakedNoise(FragPos).r * noiseIntensity + noiseOffset;
+    vec3 objectColor = baseColor * noiseValue;
+    
+    // Ambient
+    float ambientStrength = 0.2;
+    vec3 ambient = ambientStrength * objectColor;
+    
+    // Diffuse
+    vec3 norm = normalize(Normal);
+    vec3 lightDir = normalize(lightPos - FragPos);
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = diff * objectColor;
+    
+    // Specular
+    float specularStrength = 1.0;
+    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 64);
+    vec3 specular = specularStrength * spec * vec3(1.0);
+    
+    vec3 result = ambient + diffuse + specular;
+    FragColor = vec4(result, 1.0);
+} 
\ No newline at end of file
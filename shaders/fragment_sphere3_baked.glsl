@@ -0,0 +1,52 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 FragPos;
+in vec3 Normal;
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec3 lightPos;
+};
+
+#include "noise/baked.glsl"
+
+// Uniforms for noise and appearance
+layout (std140) uniform Material {
+    vec3 baseColor;
+    float noiseScale;
+    float normalStrength;
+    float glossiness;
+};
+
+void main() {
+    // Noise-based normal perturbation, baked as (n - nx, n - ny)
+    vec2 slope = sampleBakedNoise(FragPos).rg;
+    
+    // Calculate normal perturbation
+    vec3 perturbation = vec3(slope, 0.0) * normalStrength;
+    vec3 norm = normalize(Normal + perturbation);
+    
+    // Lighting calculations with perturbed normal
+    vec3 lightDir = normalize(lightPos - FragPos);
+    float diff = max(dot(norm, lightDir), 0.0);
+    
+    // Ambient
+    float ambientStrength = 0.2;
+    vec3 ambient = ambientStrength * baseColor;
+    
+    // Diffuse with noise-affected normal
+    vec3 diffuse = diff * baseColor;
+    
+    // Specular with adjustable glossiness
+    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), glossiness);
+    float specularStrength = 1.0;
+    vec3 specular = specularStrength * spec * vec3(1.0);
+    
+    vec3 result = ambient + diffuse + specular;
+    FragColor = vec4(result, 1.0);
+} 
\ No newline at end of file
@@ -0,0 +1,24 @@
+// Object transform: the model and normal matrix uniforms, or with INSTANCED
+// per-instance attributes, advancing once per instance. Normal matrices come
+// from the CPU, so vertex shaders never invert. Instances also carry their
+// material: the bytes of the std140 Material block, which the fragment
+// shader reads back from InstanceMaterial in place of the block.
+#ifdef INSTANCED
+layout (location = 2) in mat4 aModel;
+layout (location = 6) in mat3 aNormalMatrix;
+layout (location = 9) in uvec4 aMaterial0;
+layout (location = 10) in uvec4 aMaterial1;
+layout (location = 11) in uvec4 aMaterial2;
+flat out uvec4 InstanceMaterial[3];
+#define model aModel
+#define normalMatrix aNormalMatrix
+
+void passInstanceMaterial() {
+    InstanceMaterial[0] = aMaterial0;
+    InstanceMaterial[1] = aMaterial1;
+    InstanceMaterial[2] = aMaterial2;
+}
+#else
+uniform mat4 model;
+uniform mat3 normalMatrix;
+#endif
@@ -0,0 +1,8 @@
+// Noise field baked on the CPU over the object's bounds (see Bake.h)
+uniform sampler3D bakedNoise;
+uniform vec3 bakedMin;
+uniform vec3 bakedInvSize;
+
+vec4 sampleBakedNoise(vec3 worldPos) {
+    return texture(bakedNoise, (worldPos - bakedMin) * bakedInvSize);
+}
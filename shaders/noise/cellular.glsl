@@ -0,0 +1,29 @@
+// Hash function for cellular noise
+vec3 hash3(vec3 p) {
+    p = vec3(dot(p,vec3(127.1,311.7, 74.7)),
+             dot(p,vec3(269.5,183.3,246.1)),
+             dot(p,vec3(113.5,271.9,124.6)));
+    return -1.0 + 2.0 * fract(sin(p)*43758.5453123);
+}
+
+// Cellular (Worley) noise: distance to the nearest feature point
+float cellular(vec3 p) {
+    vec3 i_p = floor(p);
+    vec3 f_p = fract(p);
+    
+    float min_dist = 1.0;
+    
+    // Search neighboring cells
+    for(int k=-1; k<=1; k++)
+    for(int j=-1; j<=1; j++)
+    for(int i=-1; i<=1; i++) {
+        vec3 neighbor = vec3(float(i), float(j), float(k));
+        vec3 point = hash3(i_p + neighbor);
+        point = 0.5 + 0.5 * sin(point * 6.2831853); // Animate points
+        vec3 diff = neighbor + point - f_p;
+        float dist = length(diff);
+        min_dist = min(min_dist, dist);
+    }
+    
+    return min_dist;
+}
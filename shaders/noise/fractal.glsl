@@ -0,0 +1,64 @@
+#include "noise/perlin.glsl"
+#include "noise/simplex.glsl"
+
+// Octave counts of fbm and turbulence; a shader can define its own before
+// the include
+#ifndef FBM_OCTAVES
+#define FBM_OCTAVES 4
+#endif
+#ifndef TURBULENCE_OCTAVES
+#define TURBULENCE_OCTAVES 4
+#endif
+
+// Perlin noise summed over octaves
+float fbm(vec3 pos) {
+    float amplitude = 0.5;
+    float frequency = 1.0;
+    float noiseSum = 0.0;
+    float amplitudeSum = 0.0;
+    
+    // Add multiple octaves of noise
+    for(int i = 0; i < FBM_OCTAVES; i++) {
+        noiseSum += amplitude * cnoise(pos * frequency);
+        amplitudeSum += amplitude;
+        amplitude *= 0.5;
+        frequency *= 2.0;
+    }
+    
+    return noiseSum / amplitudeSum;
+}
+
+// Like fbm, on the absolute value of each octave
+float turbulence(vec3 pos) {
+    float sum = 0.0;
+    float frequency = 1.0;
+    float amplitude = 1.0;
+    float maxValue = 0.0;
+    
+    for(int i = 0; i < TURBULENCE_OCTAVES; i++) {
+        sum += abs(cnoise(pos * frequency)) * amplitude;
+        maxValue += amplitude;
+        amplitude *= 0.5;
+        frequency *= 2.0;
+    }
+    
+    return sum / maxValue;
+}
+
+// Simplex octaves multiplied together, each weighted by the running value.
+// With a constant octave count the loop unrolls once inlined.
+float multifractal(vec3 pos, float H, float lacunarity, int octaves) {
+    float value = 1.0;
+    float frequency = 1.0;
+    float amplitude = 0.5;
+    float weight = 1.0;
+    
+    for(int i = 0; i < octaves; i++) {
+        value *= (weight * snoise(pos * frequency) + 1.0);
+        frequency *= lacunarity;
+        weight = value;
+        weight = clamp(weight, 0.0, 1.0);
+    }
+    
+    return value;
+}
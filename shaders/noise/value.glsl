@@ -0,0 +1,15 @@
+// Value noise from a sin hash; squared, so biased towards 0
+float rand(vec2 co) {
+    return fract(sin(dot(co.xy ,vec2(12.9898,78.233))) * 43758.5453);
+}
+
+float valueNoise(vec2 p) {
+    vec2 ip = floor(p);
+    vec2 u = fract(p);
+    u = u * u * (3.0 - 2.0 * u);
+    
+    float res = mix(
+        mix(rand(ip), rand(ip+vec2(1.0,0.0)), u.x),
+        mix(rand(ip+vec2(0.0,1.0)), rand(ip+vec2(1.0,1.0)), u.x), u.y);
+    return res * res;
+}
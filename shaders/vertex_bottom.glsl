@@ -1,19 +1,25 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform mat3 normalMatrix;   // Inverse transpose of model, from the CPU
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec3 lightPos;
+};
 
 out vec3 FragPos;
 out vec3 Normal;
 out mat3 TBN;
 
+invariant gl_Position;
+
 void main() {
     gl_Position = projection * view * model * vec4(aPos, 1.0);
     FragPos = vec3(model * vec4(aPos, 1.0));
     
-    // Calculate normal matrix
-    mat3 normalMatrix = transpose(inverse(mat3(model)));
     Normal = normalize(normalMatrix * vec3(0.0, 1.0, 0.0));
     
     // Calculate tangent space matrix
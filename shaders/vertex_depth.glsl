@@ -0,0 +1,19 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+
+#include "instancing.glsl"
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec3 lightPos;
+};
+
+// Must match the shading vertex shaders exactly, which all declare
+// gl_Position invariant too, or GL_EQUAL in the shading pass drops pixels
+invariant gl_Position;
+
+void main() {
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+}
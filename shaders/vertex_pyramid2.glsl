@@ -2,15 +2,25 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+#include "instancing.glsl"
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec3 lightPos;
+};
 
 out vec3 FragPos;
 out vec3 Normal;
 
+invariant gl_Position;
+
 void main() {
     FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    Normal = normalMatrix * aNormal;
     gl_Position = projection * view * model * vec4(aPos, 1.0);
+#ifdef INSTANCED
+    passInstanceMaterial();
+#endif
 } 
\ No newline at end of file
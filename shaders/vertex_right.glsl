@@ -1,11 +1,18 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;
+    vec3 lightPos;
+};
 
 out vec3 FragPos;
 
+invariant gl_Position;
+
 void main() {
     gl_Position = projection * view * model * vec4(aPos, 1.0);
     FragPos = aPos;
@@ -0,0 +1,41 @@
+// Wood grain shared by the four walls. The including shader declares
+// WOOD_PLANE, the two FragPos components the wall spans.
+out vec4 FragColor;
+in vec3 FragPos;
+
+#include "noise/value.glsl"
+
+void main() {
+    // Wood grain parameters
+    float scale = 15.0;
+    vec2 pos = FragPos.WOOD_PLANE * scale;
+    
+    // Create wood grain layers
+    float grain = valueNoise(pos);
+    grain += 0.5 * valueNoise(pos * 3.0);
+    grain += 0.25 * valueNoise(pos * 6.0);
+    
+    // Create wood rings with natural variation
+    float ringFreq = 3.0;
+    float distortion = grain * 0.4;
+    float rings = sin(pos.x * ringFreq + distortion * 8.0) * 0.5 + 0.5;
+    rings = pow(rings, 1.5);
+    
+    // Add fine grain detail
+    float detail = valueNoise(pos * 12.0) * 0.1;
+    rings = mix(rings, detail, 0.15);
+    
+    // Warm wood colors
+    vec3 lightWood = vec3(0.85, 0.55, 0.27);    // Light oak color
+    vec3 darkWood = vec3(0.45, 0.25, 0.12);     // Dark oak color
+    vec3 midWood = vec3(0.65, 0.40, 0.20);      // Medium oak color
+    
+    // Create final wood color with three-way mix
+    vec3 woodColor = mix(darkWood, midWood, rings);
+    woodColor = mix(woodColor, lightWood, grain * 0.5);
+    
+    // Add subtle variation
+    woodColor += vec3(valueNoise(pos * 24.0) * 0.03);
+    
+    FragColor = vec4(woodColor, 1.0);
+}
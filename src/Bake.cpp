@@ -0,0 +1,159 @@
+#include "Bake.h"
+#include "FrameStats.h"
+#include <glm/gtc/packing.hpp>
+#include <cstring>
+#include <utility>
+
+void transformSamples(const NoiseSamples& samples, float scale, const glm::vec3& offset, NoiseSamples& out) {
+    size_t count = samples.size();
+    out.x.resize(count);
+    out.y.resize(count);
+    out.z.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        out.x[i] = samples.x[i] * scale + offset.x;
+        out.y[i] = samples.y[i] * scale + offset.y;
+        out.z[i] = samples.z[i] * scale + offset.z;
+    }
+}
+
+static void bakeSlice(BakeTask& task, int z) {
+    size_t sliceSize = (size_t)task.size.x * task.size.y;
+    glm::vec3 voxelSize = (task.bounds.max - task.bounds.min) / glm::vec3(task.size);
+
+    NoiseSamples samples;
+    samples.x.resize(sliceSize);
+    samples.y.resize(sliceSize);
+    samples.z.resize(sliceSize);
+    size_t i = 0;
+    for (int y = 0; y < task.size.y; y++) {
+        for (int x = 0; x < task.size.x; x++, i++) {
+            glm::vec3 position = task.bounds.min + (glm::vec3(x, y, z) + 0.5f) * voxelSize;
+            samples.x[i] = position.x;
+            samples.y[i] = position.y;
+            samples.z[i] = position.z;
+        }
+    }
+
+    std::vector<float> values(sliceSize * task.channels);
+    float* channelValues[BAKE_MAX_CHANNELS];
+    for (int c = 0; c < task.channels; c++) {
+        channelValues[c] = &values[c * sliceSize];
+    }
+    task.field(samples, channelValues);
+
+    // Half floats are plenty for values that end up as colour weights, and
+    // converting here keeps it off the render thread and halves the upload
+    uint16_t* out = &task.voxels[z * sliceSize * task.channels];
+    for (i = 0; i < sliceSize; i++) {
+        for (int c = 0; c < task.channels; c++) {
+            *out++ = glm::packHalf1x16(channelValues[c][i]);
+        }
+    }
+}
+
+void startBake(JobSystem& jobs, BakeTask& task) {
+    task.voxels.resize((size_t)task.size.x * task.size.y * task.size.z * task.channels);
+    for (int z = 0; z < task.size.z; z++) {
+        submitJob(jobs, task.group, [&task, z]() {
+            if (task.cancelled) return;
+            bakeSlice(task, z);
+            task.slicesDone++;
+        });
+    }
+}
+
+bool bakeFinished(const BakeTask& task) {
+    return isGroupDone(task.group);
+}
+
+float bakeProgress(const BakeTask& task) {
+    return (float)task.slicesDone / (float)task.size.z;
+}
+
+void cancelBake(BakeTask& task) {
+    task.cancelled = true;
+}
+
+void createUploadRing(UploadRing& ring) {
+    glGenBuffers(UPLOAD_RING_SIZE, ring.buffers);
+}
+
+void deleteUploadRing(UploadRing& ring) {
+    for (int i = 0; i < UPLOAD_RING_SIZE; i++) {
+        if (ring.fences[i]) glDeleteSync(ring.fences[i]);
+        ring.fences[i] = 0;
+        ring.capacity[i] = 0;
+    }
+    glDeleteBuffers(UPLOAD_RING_SIZE, ring.buffers);
+}
+
+VolumeData bakedData(const BakeTask& task) {
+    VolumeData data = {task.key, task.bounds, task.size, task.channels, task.voxels.data()};
+    return data;
+}
+
+void uploadVolume(BakedVolume& volume, const VolumeData& data, UploadRing& ring, unsigned int textureUnit) {
+    static const GLenum internalFormats[BAKE_MAX_CHANNELS] = {GL_R16F, GL_RG16F};
+    static const GLenum formats[BAKE_MAX_CHANNELS] = {GL_RED, GL_RG};
+    size_t bytes = (size_t)data.size.x * data.size.y * data.size.z * data.channels * sizeof(uint16_t);
+
+    // Normally signalled long ago; waiting only matters when uploads come
+    // faster than the ring turns over
+    int slot = ring.next;
+    ring.next = (ring.next + 1) % UPLOAD_RING_SIZE;
+    if (ring.fences[slot]) {
+        glClientWaitSync(ring.fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        glDeleteSync(ring.fences[slot]);
+        ring.fences[slot] = 0;
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, ring.buffers[slot]);
+    if (ring.capacity[slot] < bytes) {
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, NULL, GL_STREAM_DRAW);
+        ring.capacity[slot] = bytes;
+    }
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes,
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    std::memcpy(mapped, data.voxels, bytes);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    if (volume.backTexture == 0) {
+        glGenTextures(1, &volume.backTexture);
+    }
+    glActiveTexture(GL_TEXTURE0 + textureUnit);
+    glBindTexture(GL_TEXTURE_3D, volume.backTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    if (volume.backSize != data.size || volume.backChannels != data.channels) {
+        glTexImage3D(GL_TEXTURE_3D, 0, internalFormats[data.channels - 1], data.size.x, data.size.y, data.size.z,
+                     0, formats[data.channels - 1], GL_HALF_FLOAT, NULL);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        volume.backSize = data.size;
+        volume.backChannels = data.channels;
+    }
+    glTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, 0, data.size.x, data.size.y, data.size.z,
+                    formats[data.channels - 1], GL_HALF_FLOAT, (void*)0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    ring.fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    // Swap: the new texture and everything describing it change together,
+    // and the old front becomes the next upload's target
+    std::swap(volume.texture, volume.backTexture);
+    std::swap(volume.size, volume.backSize);
+    std::swap(volume.channels, volume.backChannels);
+    volume.key = data.key;
+    volume.bounds = data.bounds;
+    glActiveTexture(GL_TEXTURE0);
+
+    frameStats.volumeBakes++;
+}
+
+void deleteVolume(BakedVolume& volume) {
+    glDeleteTextures(1, &volume.texture);
+    glDeleteTextures(1, &volume.backTexture);
+    volume = BakedVolume();
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Frustum.h"
+#include "Hash.h"
+#include "JobSystem.h"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Noise fields baked on the CPU into 3D textures. A volume covers an object's
+// world-space bounds with voxel centres sampled at
+//   min + (index + 0.5) / size * (max - min)
+// so the baked shaders look it up with (FragPos - min) / (max - min).
+// Each volume remembers the key (a hash of the parameters it was baked
+// from) and is only re-baked when the key changes.
+const int BAKE_MAX_CHANNELS = 2;
+
+// World-space sample positions as separate x, y and z arrays, so fields can
+// go through the batched noise functions
+struct NoiseSamples {
+    std::vector<float> x, y, z;
+    size_t size() const { return x.size(); }
+};
+
+// Writes channel c of sample i to channels[c][i]
+typedef std::function<void(const NoiseSamples& samples, float* const* channels)> NoiseField;
+
+// Double buffered: uploads go to the back texture, which then swaps with the
+// front one, so the texture being sampled is never written to
+struct BakedVolume {
+    unsigned int texture = 0;       // Front, bound to the volume's texture unit
+    uint64_t key = 0;               // 0 until something has been baked
+    Bounds bounds;
+    glm::ivec3 size = glm::ivec3(0);
+    int channels = 0;
+
+    unsigned int backTexture = 0;
+    glm::ivec3 backSize = glm::ivec3(0);    // Storage the back texture has
+    int backChannels = 0;
+};
+
+// Pixel unpack buffers cycled through for uploads. A fence per buffer tells
+// when the GPU has consumed it, so the next write never waits on the upload
+// before it.
+const int UPLOAD_RING_SIZE = 3;
+
+struct UploadRing {
+    unsigned int buffers[UPLOAD_RING_SIZE] = {};
+    size_t capacity[UPLOAD_RING_SIZE] = {};
+    GLsync fences[UPLOAD_RING_SIZE] = {};
+    int next = 0;
+};
+
+// out = samples * scale + offset
+void transformSamples(const NoiseSamples& samples, float scale, const glm::vec3& offset, NoiseSamples& out);
+
+// A bake running on the job system, one job per z slice. The field is
+// called from several threads at once, so it must not touch shared state.
+// voxels holds half floats, channels interleaved, x fastest. The task must stay alive
+// until bakeFinished, cancelled or not.
+struct BakeTask {
+    uint64_t key = 0;
+    Bounds bounds;
+    glm::ivec3 size;
+    int channels = 0;
+    NoiseField field;
+    std::vector<uint16_t> voxels;
+
+    JobGroup group;
+    std::atomic<int> slicesDone{0};
+    std::atomic<bool> cancelled{false};
+};
+
+void startBake(JobSystem& jobs, BakeTask& task);
+
+// Every slice job has returned, including skipped ones after a cancel
+bool bakeFinished(const BakeTask& task);
+
+// Fraction of slices baked, 0 to 1
+float bakeProgress(const BakeTask& task);
+
+// Slices not started yet are skipped
+void cancelBake(BakeTask& task);
+
+void createUploadRing(UploadRing& ring);
+void deleteUploadRing(UploadRing& ring);
+
+// Half-float voxels ready for upload, from a finished bake or the disk cache
+struct VolumeData {
+    uint64_t key;
+    Bounds bounds;
+    glm::ivec3 size;
+    int channels;
+    const uint16_t* voxels;
+};
+
+VolumeData bakedData(const BakeTask& task);
+
+// Uploads into the back texture through the ring, then swaps it to the
+// front and binds it to textureUnit
+void uploadVolume(BakedVolume& volume, const VolumeData& data, UploadRing& ring, unsigned int textureUnit);
+
+void deleteVolume(BakedVolume& volume);
@@ -0,0 +1,505 @@
+#include "Benchmark.h"
+#include "FrameStats.h"
+#include "GLExtensions.h"
+#include <glad/glad.h>
+#ifdef ROOMS_HEADLESS
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+struct CameraKey {
+    glm::vec3 position;
+    float yaw;
+    float pitch;
+};
+
+// Room 1 -> corridor 1 -> room 2 -> corridor 2 -> room 3, then a look back
+// through both doorways. Doorways are 1.6 wide and open between y = -5 and
+// y = -2.5, so the camera drops to y = -3.75 to pass through them.
+static const CameraKey cameraPath[] = {
+    {glm::vec3(-4.5f, -1.0f,  4.5f),  -30.0f, -20.0f},  // Room 1, facing the objects
+    {glm::vec3(-1.0f, -2.5f,  3.0f),  -60.0f, -10.0f},
+    {glm::vec3( 3.0f, -3.75f, 0.0f),    0.0f,   0.0f},
+    {glm::vec3( 7.5f, -3.75f, 0.0f),    0.0f,   0.0f},  // Corridor 1
+    {glm::vec3(11.5f, -3.5f,  0.0f),    0.0f,  -5.0f},
+    {glm::vec3(14.0f, -2.0f,  3.5f),  -45.0f, -15.0f},  // Room 2
+    {glm::vec3(18.0f, -3.0f,  1.0f),  -20.0f,  -5.0f},
+    {glm::vec3(19.0f, -3.75f, 0.0f),    0.0f,   0.0f},
+    {glm::vec3(22.5f, -3.75f, 0.0f),    0.0f,   0.0f},  // Corridor 2
+    {glm::vec3(26.5f, -3.5f,  0.0f),    0.0f,  -5.0f},
+    {glm::vec3(29.0f, -2.0f,  0.0f),   30.0f, -15.0f},  // Room 3
+    {glm::vec3(30.0f, -2.5f,  0.0f),  -30.0f, -10.0f},
+    {glm::vec3(33.0f, -3.75f, 0.0f),  180.0f,   0.0f},  // Looking back towards room 1
+};
+
+bool parseBenchmarkArgs(int argc, char** argv, BenchmarkOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--benchmark") == 0) {
+            options.enabled = true;
+        } else if (std::strcmp(argv[i], "--frames") == 0 && hasValue) {
+            options.frames = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--warmup") == 0 && hasValue) {
+            options.warmupFrames = std::max(0, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--output") == 0 && hasValue) {
+            options.outputPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--depth-prepass") == 0) {
+            options.depthPrepass = true;
+        } else if (std::strcmp(argv[i], "--baked-noise") == 0) {
+            options.bakedNoise = true;
+        } else if (std::strcmp(argv[i], "--noise-benchmark") == 0) {
+            options.noiseBenchmark = true;
+        } else if (std::strcmp(argv[i], "--bake-benchmark") == 0) {
+            options.bakeBenchmark = true;
+        } else if (std::strcmp(argv[i], "--variant-benchmark") == 0) {
+            options.variantBenchmark = true;
+        } else if (std::strcmp(argv[i], "--gallery-benchmark") == 0) {
+            options.galleryBenchmark = true;
+        } else if (std::strcmp(argv[i], "--vertex-format-benchmark") == 0) {
+            options.vertexFormatBenchmark = true;
+        } else if (std::strcmp(argv[i], "--shader-files") == 0) {
+            options.shaderFiles = true;
+        } else {
+            std::cout << "Unknown argument: " << argv[i] << std::endl;
+            std::cout << "Usage: " << argv[0] << " [--benchmark] [--frames N] [--warmup N] [--output FILE] [--depth-prepass] [--baked-noise] [--noise-benchmark] [--bake-benchmark] [--variant-benchmark] [--gallery-benchmark] [--vertex-format-benchmark] [--shader-files]" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void sampleCameraPath(float t, glm::vec3& position, glm::vec3& front) {
+    const int segments = sizeof(cameraPath) / sizeof(cameraPath[0]) - 1;
+    float s = glm::clamp(t, 0.0f, 1.0f) * segments;
+    int i = std::min(static_cast<int>(s), segments - 1);
+    float f = s - i;
+    f = f * f * (3.0f - 2.0f * f);  // Ease in and out of each key
+
+    const CameraKey& a = cameraPath[i];
+    const CameraKey& b = cameraPath[i + 1];
+    position = glm::mix(a.position, b.position, f);
+    float yaw = glm::mix(a.yaw, b.yaw, f);
+    float pitch = glm::mix(a.pitch, b.pitch, f);
+
+    front.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+    front.y = sin(glm::radians(pitch));
+    front.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+    front = glm::normalize(front);
+}
+
+struct FrameSample {
+    double cpuMs;
+    double gpuMs;
+    double frameMs;
+    double fragmentInvocations;
+    FrameStats stats;
+};
+
+// ARB_pipeline_statistics_query (core in 4.6); the glad loader only covers
+// 3.3, but the query itself goes through the 3.3 glBeginQuery entry points
+#ifndef GL_FRAGMENT_SHADER_INVOCATIONS_ARB
+#define GL_FRAGMENT_SHADER_INVOCATIONS_ARB 0x82F4
+#endif
+
+static double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * values.size()));
+    return values[std::min(values.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+static void writeSummary(std::ostream& out, const char* name, const std::vector<double>& values) {
+    double sum = 0.0;
+    for (double v : values) sum += v;
+    out << "    \"" << name << "\": {"
+        << "\"mean\": " << (values.empty() ? 0.0 : sum / values.size())
+        << ", \"p50\": " << percentile(values, 50.0)
+        << ", \"p95\": " << percentile(values, 95.0)
+        << ", \"p99\": " << percentile(values, 99.0)
+        << ", \"max\": " << (values.empty() ? 0.0 : *std::max_element(values.begin(), values.end()))
+        << "}";
+}
+
+// Every report starts with the renderer; prints the error and returns false
+// when the output file can't be written
+static bool beginReport(std::ofstream& out, const BenchmarkOptions& options) {
+    out.open(options.outputPath);
+    if (!out) {
+        std::cout << "ERROR::BENCHMARK::CANNOT_WRITE_OUTPUT: " << options.outputPath << std::endl;
+        return false;
+    }
+    out << "{\n";
+    out << "  \"renderer\": \"" << glGetString(GL_RENDERER) << "\",\n";
+    return true;
+}
+
+int runBenchmark(const BenchmarkOptions& options,
+                 const std::function<void(const glm::vec3& position, const glm::vec3& front)>& renderFrame) {
+    typedef std::chrono::steady_clock Clock;
+
+    unsigned int timerQuery;
+    glGenQueries(1, &timerQuery);
+
+    unsigned int invocationsQuery = 0;
+    bool pipelineStatistics = hasExtension("GL_ARB_pipeline_statistics_query");
+    if (pipelineStatistics) {
+        glGenQueries(1, &invocationsQuery);
+    }
+
+    std::vector<FrameSample> samples;
+    samples.reserve(options.frames);
+
+    // Warmup frames hold the first camera key so driver-side shader
+    // compilation and allocation do not leak into the measured frames.
+    for (int frame = 0; frame < options.warmupFrames + options.frames; frame++) {
+        int measured = frame - options.warmupFrames;
+        float t = measured <= 0 || options.frames == 1 ? 0.0f : (float)measured / (float)(options.frames - 1);
+
+        glm::vec3 position, front;
+        sampleCameraPath(t, position, front);
+
+        Clock::time_point frameStart = Clock::now();
+        glBeginQuery(GL_TIME_ELAPSED, timerQuery);
+        if (pipelineStatistics) glBeginQuery(GL_FRAGMENT_SHADER_INVOCATIONS_ARB, invocationsQuery);
+        renderFrame(position, front);
+        if (pipelineStatistics) glEndQuery(GL_FRAGMENT_SHADER_INVOCATIONS_ARB);
+        glEndQuery(GL_TIME_ELAPSED);
+        Clock::time_point cpuEnd = Clock::now();
+
+        // Fence every frame so each sample stands on its own
+        glFinish();
+        Clock::time_point frameEnd = Clock::now();
+
+        GLuint64 gpuNs = 0;
+        glGetQueryObjectui64v(timerQuery, GL_QUERY_RESULT, &gpuNs);
+        GLuint64 invocations = 0;
+        if (pipelineStatistics) {
+            glGetQueryObjectui64v(invocationsQuery, GL_QUERY_RESULT, &invocations);
+        }
+
+        if (measured >= 0) {
+            FrameSample sample;
+            sample.cpuMs = std::chrono::duration<double, std::milli>(cpuEnd - frameStart).count();
+            sample.gpuMs = gpuNs / 1.0e6;
+            sample.frameMs = std::chrono::duration<double, std::milli>(frameEnd - frameStart).count();
+            sample.fragmentInvocations = (double)invocations;
+            sample.stats = frameStats;
+            samples.push_back(sample);
+        }
+    }
+
+    glDeleteQueries(1, &timerQuery);
+    if (pipelineStatistics) {
+        glDeleteQueries(1, &invocationsQuery);
+    }
+
+    std::vector<double> cpu, gpu, total, fragments;
+    std::vector<const char*> counterNames;
+    std::vector<std::vector<double>> counterValues;
+    for (const FrameSample& s : samples) {
+        cpu.push_back(s.cpuMs);
+        gpu.push_back(s.gpuMs);
+        total.push_back(s.frameMs);
+        fragments.push_back(s.fragmentInvocations);
+
+        size_t c = 0;
+        forEachCounter(s.stats, [&](const char* name, unsigned int value) {
+            if (c == counterNames.size()) {
+                counterNames.push_back(name);
+                counterValues.push_back(std::vector<double>());
+            }
+            counterValues[c++].push_back(value);
+        });
+    }
+
+    std::ofstream out;
+    if (!beginReport(out, options)) return -1;
+    out << "  \"version\": \"" << glGetString(GL_VERSION) << "\",\n";
+    out << "  \"width\": " << BENCHMARK_WIDTH << ",\n";
+    out << "  \"height\": " << BENCHMARK_HEIGHT << ",\n";
+    out << "  \"warmup_frames\": " << options.warmupFrames << ",\n";
+    out << "  \"frames\": " << samples.size() << ",\n";
+    out << "  \"depth_prepass\": " << (options.depthPrepass ? "true" : "false") << ",\n";
+    out << "  \"baked_noise\": " << (options.bakedNoise ? "true" : "false") << ",\n";
+    out << "  \"summary\": {\n";
+    writeSummary(out, "cpu_ms", cpu);
+    out << ",\n";
+    writeSummary(out, "gpu_ms", gpu);
+    out << ",\n";
+    writeSummary(out, "frame_ms", total);
+    if (pipelineStatistics) {
+        out << ",\n";
+        writeSummary(out, "fragment_invocations", fragments);
+    }
+    out << "\n  },\n";
+    out << "  \"counters\": {\n";
+    for (size_t c = 0; c < counterNames.size(); c++) {
+        writeSummary(out, counterNames[c], counterValues[c]);
+        out << (c + 1 < counterNames.size() ? ",\n" : "\n");
+    }
+    out << "  },\n";
+    out << "  \"per_frame\": [\n";
+    for (size_t i = 0; i < samples.size(); i++) {
+        out << "    {\"frame\": " << i
+            << ", \"cpu_ms\": " << samples[i].cpuMs
+            << ", \"gpu_ms\": " << samples[i].gpuMs
+            << ", \"frame_ms\": " << samples[i].frameMs;
+        if (pipelineStatistics) {
+            out << ", \"fragment_invocations\": " << samples[i].fragmentInvocations;
+        }
+        forEachCounter(samples[i].stats, [&](const char* name, unsigned int value) {
+            out << ", \"" << name << "\": " << value;
+        });
+        out << "}"
+            << (i + 1 < samples.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+
+    std::cout << "Benchmark: " << samples.size() << " frames on " << glGetString(GL_RENDERER) << std::endl;
+    std::cout << "  frame p50 " << percentile(total, 50.0) << " ms, p95 " << percentile(total, 95.0)
+              << " ms, p99 " << percentile(total, 99.0) << " ms (gpu p50 " << percentile(gpu, 50.0) << " ms)" << std::endl;
+    if (pipelineStatistics) {
+        std::cout << "  fragment shader invocations p50 " << percentile(fragments, 50.0) << std::endl;
+    }
+    std::cout << "  report written to " << options.outputPath << std::endl;
+    return 0;
+}
+
+// p50 times of one case of the benchmarks below over the measured frames
+struct CaseTiming {
+    double frameMs;     // Wall clock to a glFinish
+    double cpuMs;       // Until drawFrame returned
+    double gpuMs;       // GL_TIME_ELAPSED, when timed with a query
+};
+
+// Draws warmup + measured frames of one case, fencing each with glFinish
+static CaseTiming timeCase(const BenchmarkOptions& options, const std::function<void()>& drawFrame,
+                           unsigned int timerQuery = 0) {
+    typedef std::chrono::steady_clock Clock;
+
+    std::vector<double> total, cpu, gpu;
+    for (int frame = 0; frame < options.warmupFrames + options.frames; frame++) {
+        Clock::time_point frameStart = Clock::now();
+        if (timerQuery) glBeginQuery(GL_TIME_ELAPSED, timerQuery);
+        drawFrame();
+        if (timerQuery) glEndQuery(GL_TIME_ELAPSED);
+        Clock::time_point submitted = Clock::now();
+        glFinish();
+        Clock::time_point frameEnd = Clock::now();
+
+        GLuint64 gpuNs = 0;
+        if (timerQuery) glGetQueryObjectui64v(timerQuery, GL_QUERY_RESULT, &gpuNs);
+        if (frame >= options.warmupFrames) {
+            total.push_back(std::chrono::duration<double, std::milli>(frameEnd - frameStart).count());
+            cpu.push_back(std::chrono::duration<double, std::milli>(submitted - frameStart).count());
+            gpu.push_back(gpuNs / 1.0e6);
+        }
+    }
+
+    CaseTiming timing;
+    timing.frameMs = percentile(total, 50.0);
+    timing.cpuMs = percentile(cpu, 50.0);
+    timing.gpuMs = percentile(gpu, 50.0);
+    return timing;
+}
+
+// Writes {"renderer", "frames", "results": [...]}, one JSON object per case
+static int writeCaseReport(const BenchmarkOptions& options, const std::vector<std::string>& results) {
+    std::ofstream out;
+    if (!beginReport(out, options)) return -1;
+    out << "  \"frames\": " << options.frames << ",\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        out << "    " << results[i] << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+
+    std::cout << "  report written to " << options.outputPath << std::endl;
+    return 0;
+}
+
+static void printCaseHeader(const char* name, const BenchmarkOptions& options, const char* columns) {
+    std::cout << name << " benchmark: " << options.frames << " frames per case on " << glGetString(GL_RENDERER)
+              << ", p50 " << columns << std::endl;
+}
+
+int runVariantBenchmark(const BenchmarkOptions& options,
+                        const std::function<void(int octaves, bool specialized)>& drawFrame) {
+    const int maxOctaves = 8;
+
+    unsigned int timerQuery;
+    glGenQueries(1, &timerQuery);
+
+    printCaseHeader("Variant", options, "ms uniform loop / specialised");
+    std::vector<std::string> results;
+    for (int octaves = 1; octaves <= maxOctaves; octaves++) {
+        // [specialized]
+        CaseTiming timing[2];
+        for (int specialized = 0; specialized < 2; specialized++) {
+            timing[specialized] = timeCase(options, [&]() { drawFrame(octaves, specialized == 1); }, timerQuery);
+        }
+
+        std::ostringstream result;
+        result << "{\"octaves\": " << octaves
+               << ", \"uniform_gpu_ms\": " << timing[0].gpuMs
+               << ", \"specialized_gpu_ms\": " << timing[1].gpuMs
+               << ", \"uniform_frame_ms\": " << timing[0].frameMs
+               << ", \"specialized_frame_ms\": " << timing[1].frameMs << "}";
+        results.push_back(result.str());
+        std::printf("  %d octaves  gpu %7.3f / %7.3f  frame %7.3f / %7.3f (%4.2fx)\n", octaves, timing[0].gpuMs,
+                    timing[1].gpuMs, timing[0].frameMs, timing[1].frameMs, timing[0].frameMs / timing[1].frameMs);
+    }
+    glDeleteQueries(1, &timerQuery);
+
+    return writeCaseReport(options, results);
+}
+
+int runGalleryBenchmark(const BenchmarkOptions& options,
+                        const std::function<void(int objects, bool instanced)>& drawFrame) {
+    const int objectCounts[] = {100, 500, 1000, 2000, 5000, 10000};
+    const char* const modes[2] = {"per_object", "instanced"};
+
+    printCaseHeader("Gallery", options, "per object / instanced");
+    std::vector<std::string> results;
+    for (int objects : objectCounts) {
+        // [instanced]
+        CaseTiming timing[2];
+        unsigned int draws[2];
+        for (int instanced = 0; instanced < 2; instanced++) {
+            timing[instanced] = timeCase(options, [&]() { drawFrame(objects, instanced == 1); });
+            draws[instanced] = frameStats.drawBatches;
+        }
+
+        std::ostringstream result;
+        result << "{\"objects\": " << objects;
+        for (int instanced = 0; instanced < 2; instanced++) {
+            double seconds = timing[instanced].frameMs / 1000.0;
+            result << ", \"" << modes[instanced] << "\": {\"frame_ms\": " << timing[instanced].frameMs
+                   << ", \"cpu_ms\": " << timing[instanced].cpuMs
+                   << ", \"gl_draws\": " << draws[instanced]
+                   << ", \"draws_per_second\": " << draws[instanced] / seconds
+                   << ", \"objects_per_second\": " << objects / seconds << "}";
+        }
+        result << "}";
+        results.push_back(result.str());
+        std::printf("  %5d objects  frame %8.3f / %8.3f ms  cpu %7.3f / %7.3f ms  GL draws %5u / %2u (%4.2fx)\n",
+                    objects, timing[0].frameMs, timing[1].frameMs, timing[0].cpuMs, timing[1].cpuMs, draws[0],
+                    draws[1], timing[0].frameMs / timing[1].frameMs);
+    }
+
+    return writeCaseReport(options, results);
+}
+
+int runVertexFormatBenchmark(const BenchmarkOptions& options,
+                             const std::function<void(int objects, bool compact)>& drawFrame) {
+    const int objectCounts[] = {2000, 5000, 10000};
+    const char* const layouts[2] = {"float", "compact"};
+
+    printCaseHeader("Vertex format", options, "float / compact");
+    std::vector<std::string> results;
+    for (int objects : objectCounts) {
+        // [compact]
+        CaseTiming timing[2];
+        unsigned int triangles[2];
+        for (int compact = 0; compact < 2; compact++) {
+            timing[compact] = timeCase(options, [&]() { drawFrame(objects, compact == 1); });
+            triangles[compact] = frameStats.trianglesDrawn;
+        }
+
+        std::ostringstream result;
+        result << "{\"objects\": " << objects;
+        for (int compact = 0; compact < 2; compact++) {
+            result << ", \"" << layouts[compact] << "\": {\"frame_ms\": " << timing[compact].frameMs
+                   << ", \"triangles\": " << triangles[compact]
+                   << ", \"triangles_per_second\": " << triangles[compact] / (timing[compact].frameMs / 1000.0)
+                   << "}";
+        }
+        result << "}";
+        results.push_back(result.str());
+        std::printf("  %5d objects  %8u triangles  frame %8.3f / %8.3f ms (%4.2fx)\n", objects, triangles[1],
+                    timing[0].frameMs, timing[1].frameMs, timing[0].frameMs / timing[1].frameMs);
+    }
+
+    return writeCaseReport(options, results);
+}
+
+#ifdef ROOMS_HEADLESS
+static EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+static EGLSurface eglSurface = EGL_NO_SURFACE;
+static EGLContext eglContext = EGL_NO_CONTEXT;
+
+bool createHeadlessContext(int width, int height) {
+    // Prefer the surfaceless platform: it needs neither X11 nor a GPU device
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay) {
+        eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    }
+    if (eglDisplay == EGL_NO_DISPLAY) {
+        eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    EGLint major, minor;
+    if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor)) {
+        std::cout << "ERROR::EGL::INITIALIZE_FAILED: 0x" << std::hex << eglGetError() << std::dec << std::endl;
+        return false;
+    }
+
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+        EGL_DEPTH_SIZE, 24,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint numConfigs = 0;
+    if (!eglChooseConfig(eglDisplay, configAttribs, &config, 1, &numConfigs) || numConfigs == 0) {
+        std::cout << "ERROR::EGL::NO_MATCHING_CONFIG" << std::endl;
+        return false;
+    }
+
+    const EGLint surfaceAttribs[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+    eglSurface = eglCreatePbufferSurface(eglDisplay, config, surfaceAttribs);
+
+    eglBindAPI(EGL_OPENGL_API);
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttribs);
+    if (eglSurface == EGL_NO_SURFACE || eglContext == EGL_NO_CONTEXT ||
+        !eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext)) {
+        std::cout << "ERROR::EGL::CONTEXT_CREATION_FAILED: 0x" << std::hex << eglGetError() << std::dec << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void* headlessGetProcAddress(const char* name) {
+    return (void*)eglGetProcAddress(name);
+}
+
+void destroyHeadlessContext() {
+    if (eglDisplay == EGL_NO_DISPLAY) return;
+    eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (eglContext != EGL_NO_CONTEXT) eglDestroyContext(eglDisplay, eglContext);
+    if (eglSurface != EGL_NO_SURFACE) eglDestroySurface(eglDisplay, eglSurface);
+    eglTerminate(eglDisplay);
+    eglDisplay = EGL_NO_DISPLAY;
+}
+#endif
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <functional>
+#include <string>
+
+// Scripted, repeatable frame-time measurement. The camera flies a fixed path
+// through the three rooms and both corridors and every frame is timed on the
+// CPU and on the GPU (GL_TIME_ELAPSED), then written out as JSON.
+struct BenchmarkOptions {
+    bool enabled = false;
+    int frames = 600;
+    int warmupFrames = 30;
+    std::string outputPath = "benchmark.json";
+    bool depthPrepass = false;
+    bool bakedNoise = false;
+    bool noiseBenchmark = false;
+    bool bakeBenchmark = false;
+    bool variantBenchmark = false;
+    bool galleryBenchmark = false;
+    bool vertexFormatBenchmark = false;
+    bool shaderFiles = false;   // Read shaders from ../shaders/ instead of the embedded copies
+};
+
+const int BENCHMARK_WIDTH = 1280;
+const int BENCHMARK_HEIGHT = 720;
+
+// Parses --benchmark, --frames N, --warmup N, --output FILE, --depth-prepass,
+// --baked-noise, --noise-benchmark, --bake-benchmark, --variant-benchmark,
+// --gallery-benchmark, --vertex-format-benchmark and --shader-files.
+// Returns false (after printing usage) on malformed arguments.
+bool parseBenchmarkArgs(int argc, char** argv, BenchmarkOptions& options);
+
+// Position and view direction along the benchmark path, t in [0, 1].
+void sampleCameraPath(float t, glm::vec3& position, glm::vec3& front);
+
+// Runs warmup + measured frames, calling renderFrame with the camera for each
+// one, and writes the report. Fragment shader invocations are recorded too
+// where ARB_pipeline_statistics_query is available. Returns the process exit
+// code.
+int runBenchmark(const BenchmarkOptions& options,
+                 const std::function<void(const glm::vec3& position, const glm::vec3& front)>& renderFrame);
+
+// CPU-only: times every batched noise function (and octave counts of the
+// layered ones) on each SIMD backend the CPU supports, printing ns/sample and
+// writing the results to the output file. Returns the process exit code.
+int runNoiseBenchmark(const BenchmarkOptions& options);
+
+// CPU-only: bakes the same volume on the job system with 1, 2, 4... threads
+// up to the core count and reports voxels/s and speedup for each.
+int runBakeBenchmark(const BenchmarkOptions& options);
+
+// For 1 to 8 octaves, times drawFrame with the generic program (octave loop
+// bound by a uniform) against the specialised variant (count compiled in),
+// with GL_TIME_ELAPSED and with the wall clock around a glFinish, since
+// software rasterizers do their work outside the timer query.
+int runVariantBenchmark(const BenchmarkOptions& options,
+                        const std::function<void(int octaves, bool specialized)>& drawFrame);
+
+// For 100 to 10000 objects, times frames of the gallery drawn as instanced
+// batches against one draw per object, each binding its own material block:
+// wall clock to a glFinish, the CPU time spent submitting, and the GL draws
+// issued.
+int runGalleryBenchmark(const BenchmarkOptions& options,
+                        const std::function<void(int objects, bool instanced)>& drawFrame);
+
+// For 2000 to 10000 instanced gallery objects, times frames with the
+// geometry arena in the float layout (24-byte vertices, 32-bit indices)
+// against the compact one, wall clock to a glFinish, with the triangles each
+// frame drew. Sphere level of detail is off, so triangles grow with objects.
+int runVertexFormatBenchmark(const BenchmarkOptions& options,
+                             const std::function<void(int objects, bool compact)>& drawFrame);
+
+#ifdef ROOMS_HEADLESS
+// Offscreen EGL context (surfaceless Mesa platform when available, so it also
+// works on llvmpipe without a display server).
+bool createHeadlessContext(int width, int height);
+void* headlessGetProcAddress(const char* name);
+void destroyHeadlessContext();
+#endif
@@ -0,0 +1,58 @@
+#pragma once
+
+// Levels of detail the sphere comes in; SPHERE_LOD_SEGMENTS in Rooms.cpp has
+// one entry per level
+const int SPHERE_LOD_LEVELS = 4;
+
+// Renderer counters for the current frame. Reset at the start of every frame,
+// listed in the "Frame Stats" window and recorded per frame by the benchmark.
+struct FrameStats {
+    unsigned int uniformLookups = 0;    // glGetUniformLocation string lookups
+    unsigned int materialUploads = 0;   // Material uniform buffer uploads
+    unsigned int shaderVariantBuilds = 0;   // Specialised programs started on first use
+    unsigned int volumeBakes = 0;       // Noise volumes uploaded, baked or cached
+    unsigned int volumeCacheHits = 0;   // Of those, read from the disk cache
+    unsigned int drawCalls = 0;
+    unsigned int drawBatches = 0;       // GL draws issued, after merging runs that share all state
+    unsigned int instancesDrawn = 0;    // Objects drawn by instanced draws
+    unsigned int trianglesDrawn = 0;    // In the shading pass, instances included
+    unsigned int sphereLodObjects[SPHERE_LOD_LEVELS] = {};  // Spheres drawn at each level of detail, coarsest first
+    unsigned int depthPrepassDraws = 0;
+    unsigned int programChanges = 0;            // glUseProgram calls after sorting
+    unsigned int vaoChanges = 0;                // glBindVertexArray calls after sorting
+    unsigned int programChangesUnsorted = 0;    // Same, had draws run in submission order
+    unsigned int vaoChangesUnsorted = 0;
+    unsigned int visibleCells = 0;      // Rooms and corridors reached through portals
+    unsigned int portalsTested = 0;
+    unsigned int frustumCulled = 0;     // Draws rejected by their bounds; submitted ones are drawCalls
+};
+
+extern FrameStats frameStats;
+
+// Calls f(name, value) for every counter, in report order.
+template <typename F>
+void forEachCounter(const FrameStats& stats, F f) {
+    f("uniform_lookups", stats.uniformLookups);
+    f("material_uploads", stats.materialUploads);
+    f("shader_variant_builds", stats.shaderVariantBuilds);
+    f("volume_bakes", stats.volumeBakes);
+    f("volume_cache_hits", stats.volumeCacheHits);
+    f("draw_calls", stats.drawCalls);
+    f("draw_batches", stats.drawBatches);
+    f("instances_drawn", stats.instancesDrawn);
+    f("triangles_drawn", stats.trianglesDrawn);
+    static const char* const sphereLodNames[SPHERE_LOD_LEVELS] = {
+        "sphere_lod0_objects", "sphere_lod1_objects", "sphere_lod2_objects", "sphere_lod3_objects"
+    };
+    for (int level = 0; level < SPHERE_LOD_LEVELS; level++) {
+        f(sphereLodNames[level], stats.sphereLodObjects[level]);
+    }
+    f("depth_prepass_draws", stats.depthPrepassDraws);
+    f("program_changes", stats.programChanges);
+    f("vao_changes", stats.vaoChanges);
+    f("program_changes_unsorted", stats.programChangesUnsorted);
+    f("vao_changes_unsorted", stats.vaoChangesUnsorted);
+    f("visible_cells", stats.visibleCells);
+    f("portals_tested", stats.portalsTested);
+    f("frustum_culled", stats.frustumCulled);
+}
@@ -0,0 +1,55 @@
+#include "Frustum.h"
+
+Frustum extractFrustum(const glm::mat4& viewProjection) {
+    // glm is column major, row i of the matrix is m[0][i] .. m[3][i]
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; i++) {
+        rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    }
+
+    Frustum frustum;
+    frustum.planes[0] = rows[3] + rows[0];
+    frustum.planes[1] = rows[3] - rows[0];
+    frustum.planes[2] = rows[3] + rows[1];
+    frustum.planes[3] = rows[3] - rows[1];
+    frustum.planes[4] = rows[3] + rows[2];
+    frustum.planes[5] = rows[3] - rows[2];
+
+    for (glm::vec4& plane : frustum.planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+    return frustum;
+}
+
+bool intersectsFrustum(const Frustum& frustum, const Bounds& bounds) {
+    for (const glm::vec4& plane : frustum.planes) {
+        // Corner of the box furthest along the plane normal
+        glm::vec3 positive(plane.x >= 0.0f ? bounds.max.x : bounds.min.x,
+                           plane.y >= 0.0f ? bounds.max.y : bounds.min.y,
+                           plane.z >= 0.0f ? bounds.max.z : bounds.min.z);
+        if (glm::dot(glm::vec3(plane), positive) + plane.w < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Bounds transformBounds(const Bounds& bounds, const glm::mat4& transform) {
+    Bounds result;
+    result.min = glm::vec3(transform[3]);
+    result.max = result.min;
+
+    for (int column = 0; column < 3; column++) {
+        for (int row = 0; row < 3; row++) {
+            float a = transform[column][row] * bounds.min[column];
+            float b = transform[column][row] * bounds.max[column];
+            result.min[row] += glm::min(a, b);
+            result.max[row] += glm::max(a, b);
+        }
+    }
+    return result;
+}
+
+glm::vec3 boundsCenter(const Bounds& bounds) {
+    return (bounds.min + bounds.max) * 0.5f;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// World-space axis-aligned bounds of a piece of geometry
+struct Bounds {
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+// View frustum as six inward-facing planes (xyz normal, w distance):
+// left, right, bottom, top, near, far
+struct Frustum {
+    glm::vec4 planes[6];
+};
+
+// Gribb/Hartmann plane extraction from a combined projection * view matrix
+Frustum extractFrustum(const glm::mat4& viewProjection);
+
+// Conservative test: false only when the box is fully outside one plane
+bool intersectsFrustum(const Frustum& frustum, const Bounds& bounds);
+
+// Bounds of the box after an affine transform (Arvo's method)
+Bounds transformBounds(const Bounds& bounds, const glm::mat4& transform);
+
+glm::vec3 boundsCenter(const Bounds& bounds);
@@ -0,0 +1,48 @@
+#include "GLExtensions.h"
+#include <cstring>
+
+GLExtensions glExtensions;
+
+bool hasExtension(const char* name) {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++) {
+        if (std::strcmp((const char*)glGetStringi(GL_EXTENSIONS, i), name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool hasVersion(int major, int minor) {
+    GLint contextMajor = 0, contextMinor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &contextMajor);
+    glGetIntegerv(GL_MINOR_VERSION, &contextMinor);
+    return contextMajor > major || (contextMajor == major && contextMinor >= minor);
+}
+
+void loadGLExtensions(GLADloadproc load) {
+    if (hasVersion(4, 1) || hasExtension("GL_ARB_get_program_binary")) {
+        glExtensions.getProgramBinary = (PFNGLGETPROGRAMBINARYPROC)load("glGetProgramBinary");
+        glExtensions.programBinaryLoad = (PFNGLPROGRAMBINARYPROC)load("glProgramBinary");
+        glExtensions.programParameteri = (PFNGLPROGRAMPARAMETERIPROC)load("glProgramParameteri");
+
+        // Drivers may expose the entry points with no format to use them with
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        glExtensions.programBinary = formats > 0 && glExtensions.getProgramBinary
+                                  && glExtensions.programBinaryLoad && glExtensions.programParameteri;
+    }
+
+    // Same enums and entry point under either name
+    if (hasExtension("GL_KHR_parallel_shader_compile")) {
+        glExtensions.maxShaderCompilerThreads = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)load("glMaxShaderCompilerThreadsKHR");
+    } else if (hasExtension("GL_ARB_parallel_shader_compile")) {
+        glExtensions.maxShaderCompilerThreads = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)load("glMaxShaderCompilerThreadsARB");
+    }
+    if (glExtensions.maxShaderCompilerThreads) {
+        // 0xFFFFFFFF leaves the thread count to the driver
+        glExtensions.maxShaderCompilerThreads(0xFFFFFFFF);
+        glExtensions.parallelShaderCompile = true;
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+
+// Entry points and enums beyond the GL 3.3 core that glad was generated for,
+// loaded by hand where the driver has them. Everything using one checks the
+// matching flag first.
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+typedef void (APIENTRYP PFNGLGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei* length,
+                                                   GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP PFNGLPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void* binary,
+                                                GLsizei length);
+typedef void (APIENTRYP PFNGLPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+
+struct GLExtensions {
+    // ARB_get_program_binary (core in 4.1), with at least one binary format
+    bool programBinary = false;
+    PFNGLGETPROGRAMBINARYPROC getProgramBinary = NULL;
+    PFNGLPROGRAMBINARYPROC programBinaryLoad = NULL;
+    PFNGLPROGRAMPARAMETERIPROC programParameteri = NULL;
+
+    // KHR_parallel_shader_compile (or the ARB version): compiles and links
+    // run on driver threads and GL_COMPLETION_STATUS_KHR can be polled
+    // without blocking
+    bool parallelShaderCompile = false;
+    PFNGLMAXSHADERCOMPILERTHREADSKHRPROC maxShaderCompilerThreads = NULL;
+};
+
+extern GLExtensions glExtensions;
+
+bool hasExtension(const char* name);
+
+// Call once the context is current and glad is loaded
+void loadGLExtensions(GLADloadproc load);
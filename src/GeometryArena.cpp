@@ -0,0 +1,215 @@
+#include "GeometryArena.h"
+#include "MeshOptimizer.h"
+#include <glm/gtc/packing.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+std::vector<Vertex> makeVertices(const float* data, size_t vertexCount, int stride) {
+    std::vector<Vertex> vertices(vertexCount);
+    for (size_t i = 0; i < vertexCount; i++) {
+        const float* v = data + i * stride;
+        vertices[i].position = glm::vec3(v[0], v[1], v[2]);
+        vertices[i].normal = stride >= 6 ? glm::vec3(v[3], v[4], v[5]) : glm::vec3(0.0f);
+    }
+    return vertices;
+}
+
+static Bounds rangeBounds(const GeometryArena& arena, GLint baseVertex, unsigned int firstIndex, GLsizei count) {
+    Bounds bounds;
+    bounds.min = glm::vec3(1e30f);
+    bounds.max = glm::vec3(-1e30f);
+    for (GLsizei i = 0; i < count; i++) {
+        const glm::vec3& p = arena.vertices[baseVertex + arena.indices[firstIndex + i]].position;
+        bounds.min = glm::min(bounds.min, p);
+        bounds.max = glm::max(bounds.max, p);
+    }
+    return bounds;
+}
+
+int addMesh(GeometryArena& arena, const std::string& name, const std::vector<Vertex>& vertices,
+            const unsigned int* indices, size_t indexCount) {
+    MeshRange mesh;
+    mesh.baseVertex = (GLint)arena.vertices.size();
+    mesh.firstIndex = (unsigned int)arena.indices.size();
+    mesh.count = (GLsizei)indexCount;
+    arena.vertices.insert(arena.vertices.end(), vertices.begin(), vertices.end());
+    arena.indices.insert(arena.indices.end(), indices, indices + indexCount);
+    mesh.bounds = rangeBounds(arena, mesh.baseVertex, mesh.firstIndex, mesh.count);
+
+    arena.meshes.push_back(mesh);
+    arena.meshNames.push_back(name);
+    arena.partStarts.push_back(mesh.firstIndex);
+    return (int)arena.meshes.size() - 1;
+}
+
+MeshRange meshSubrange(GeometryArena& arena, int mesh, GLsizei count, unsigned int firstIndex) {
+    MeshRange range = arena.meshes[mesh];
+    range.firstIndex += firstIndex;
+    range.count = count;
+    arena.partStarts.push_back(range.firstIndex);
+    arena.partStarts.push_back(range.firstIndex + count);
+    range.bounds = rangeBounds(arena, range.baseVertex, range.firstIndex, range.count);
+    return range;
+}
+
+void bindArenaVertices(const GeometryArena& arena) {
+    glBindBuffer(GL_ARRAY_BUFFER, arena.vbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, arena.ebo);
+    glVertexAttribPointer(0, 3, arena.positionType, GL_FALSE, arena.vertexStride, (void*)0);
+    glEnableVertexAttribArray(0);
+    // Packed normals are snorm: GL_TRUE maps them back to [-1, 1]
+    if (arena.normalType == GL_INT_2_10_10_10_REV) {
+        glVertexAttribPointer(1, 4, arena.normalType, GL_TRUE, arena.vertexStride, (void*)arena.normalOffset);
+    } else {
+        glVertexAttribPointer(1, 3, arena.normalType, GL_FALSE, arena.vertexStride, (void*)arena.normalOffset);
+    }
+    glEnableVertexAttribArray(1);
+}
+
+static size_t meshVertexCount(const GeometryArena& arena, size_t mesh) {
+    size_t end = mesh + 1 < arena.meshes.size() ? arena.meshes[mesh + 1].baseVertex : arena.vertices.size();
+    return end - arena.meshes[mesh].baseVertex;
+}
+
+// Clusters may cost this much more ACMR than the cache optimised order
+const float OVERDRAW_THRESHOLD = 1.05f;
+
+void optimizeGeometryArena(GeometryArena& arena, const std::vector<int>& blendedMeshes) {
+    std::vector<unsigned int> cuts = arena.partStarts;
+    cuts.push_back((unsigned int)arena.indices.size());
+    std::sort(cuts.begin(), cuts.end());
+    cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+
+    std::printf("Mesh optimization, FIFO cache of %u: ACMR / ATVR before -> after\n", VERTEX_CACHE_SIZE);
+    for (size_t i = 0; i < arena.meshes.size(); i++) {
+        const MeshRange& mesh = arena.meshes[i];
+        size_t vertexCount = meshVertexCount(arena, i);
+        unsigned int* indices = &arena.indices[mesh.firstIndex];
+        Vertex* vertices = &arena.vertices[mesh.baseVertex];
+        VertexCacheStats before = analyzeVertexCache(indices, mesh.count, vertexCount);
+        if (std::find(blendedMeshes.begin(), blendedMeshes.end(), (int)i) != blendedMeshes.end()) {
+            std::printf("  %-10s %5.3f / %5.3f, blended, order kept\n", arena.meshNames[i].c_str(), before.acmr,
+                        before.atvr);
+            continue;
+        }
+
+        std::vector<unsigned int> optimizedIndices(indices, indices + mesh.count);
+        std::vector<Vertex> optimizedVertices(vertices, vertices + vertexCount);
+        for (size_t c = 0; c + 1 < cuts.size(); c++) {
+            if (cuts[c] < mesh.firstIndex || cuts[c] >= mesh.firstIndex + mesh.count) continue;
+            size_t partBegin = cuts[c] - mesh.firstIndex;
+            size_t partEnd = std::min<size_t>(cuts[c + 1] - mesh.firstIndex, mesh.count);
+            unsigned int* part = &optimizedIndices[partBegin];
+            optimizeVertexCache(part, partEnd - partBegin, vertexCount);
+            optimizeOverdraw(part, partEnd - partBegin, optimizedVertices.data(), vertexCount, OVERDRAW_THRESHOLD);
+        }
+        optimizeVertexFetch(optimizedVertices.data(), vertexCount, optimizedIndices.data(), mesh.count);
+        VertexCacheStats after = analyzeVertexCache(optimizedIndices.data(), mesh.count, vertexCount);
+
+        // Only taken for a gain; hand-written quads already reuse every vertex they can
+        if (after.acmr < before.acmr) {
+            std::copy(optimizedIndices.begin(), optimizedIndices.end(), indices);
+            std::copy(optimizedVertices.begin(), optimizedVertices.end(), vertices);
+            std::printf("  %-10s %5.3f / %5.3f -> %5.3f / %5.3f\n", arena.meshNames[i].c_str(), before.acmr,
+                        before.atvr, after.acmr, after.atvr);
+        } else {
+            std::printf("  %-10s %5.3f / %5.3f, order kept\n", arena.meshNames[i].c_str(), before.acmr, before.atvr);
+        }
+    }
+}
+
+size_t indexTypeSize(GLenum type) {
+    return type == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+static void printArenaReport(const GeometryArena& arena, float positionError) {
+    std::printf("Geometry arena: %s positions (half-float error %g), %s normals, %d-bit indices, %d bytes per vertex\n",
+                arena.positionType == GL_HALF_FLOAT ? "half-float" : "float", positionError,
+                arena.normalType == GL_FLOAT ? "float" : "2_10_10_10", (int)indexTypeSize(arena.indexType) * 8,
+                (int)arena.vertexStride);
+    size_t totalBefore = 0, totalAfter = 0;
+    for (size_t i = 0; i < arena.meshes.size(); i++) {
+        const MeshRange& mesh = arena.meshes[i];
+        size_t vertexCount = meshVertexCount(arena, i);
+        size_t before = vertexCount * sizeof(Vertex) + mesh.count * sizeof(unsigned int);
+        size_t after = vertexCount * arena.vertexStride + mesh.count * indexTypeSize(arena.indexType);
+        std::printf("  %-10s %6zu vertices %6d indices %8zu -> %7zu bytes\n", arena.meshNames[i].c_str(), vertexCount,
+                    (int)mesh.count, before, after);
+        totalBefore += before;
+        totalAfter += after;
+    }
+    std::printf("  %-10s %39zu -> %7zu bytes (%.0f%%)\n", "total", totalBefore, totalAfter,
+                100.0 * totalAfter / std::max<size_t>(totalBefore, 1));
+}
+
+void uploadGeometryArena(GeometryArena& arena, bool compact) {
+    float positionError = 0.0f;
+    for (const Vertex& vertex : arena.vertices) {
+        for (int c = 0; c < 3; c++) {
+            float rounded = glm::unpackHalf1x16(glm::packHalf1x16(vertex.position[c]));
+            positionError = std::max(positionError, std::fabs(rounded - vertex.position[c]));
+        }
+    }
+    // Indices are local to their mesh, so the largest one bounds every mesh
+    unsigned int maxIndex = arena.indices.empty() ? 0 : *std::max_element(arena.indices.begin(), arena.indices.end());
+
+    bool halfPositions = compact && positionError <= HALF_POSITION_TOLERANCE;
+    size_t positionSize = halfPositions ? 4 * sizeof(uint16_t) : sizeof(glm::vec3);    // Halves padded to 4 bytes
+    arena.positionType = halfPositions ? GL_HALF_FLOAT : GL_FLOAT;
+    arena.normalType = compact ? GL_INT_2_10_10_10_REV : GL_FLOAT;
+    arena.indexType = compact && maxIndex <= 0xFFFF ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    arena.normalOffset = positionSize;
+    arena.vertexStride = (GLsizei)(positionSize + (compact ? sizeof(uint32_t) : sizeof(glm::vec3)));
+
+    std::vector<unsigned char> vertexData(arena.vertices.size() * arena.vertexStride);
+    for (size_t i = 0; i < arena.vertices.size(); i++) {
+        const Vertex& vertex = arena.vertices[i];
+        unsigned char* out = &vertexData[i * arena.vertexStride];
+        if (halfPositions) {
+            uint16_t halves[4] = {glm::packHalf1x16(vertex.position.x), glm::packHalf1x16(vertex.position.y),
+                                  glm::packHalf1x16(vertex.position.z), 0};
+            std::memcpy(out, halves, sizeof(halves));
+        } else {
+            std::memcpy(out, &vertex.position, sizeof(glm::vec3));
+        }
+        if (compact) {
+            uint32_t normal = glm::packSnorm3x10_1x2(glm::vec4(vertex.normal, 0.0f));
+            std::memcpy(out + arena.normalOffset, &normal, sizeof(normal));
+        } else {
+            std::memcpy(out + arena.normalOffset, &vertex.normal, sizeof(glm::vec3));
+        }
+    }
+    std::vector<uint16_t> shortIndices;
+    if (arena.indexType == GL_UNSIGNED_SHORT) shortIndices.assign(arena.indices.begin(), arena.indices.end());
+
+    if (arena.vao == 0) {
+        glGenVertexArrays(1, &arena.vao);
+        glGenBuffers(1, &arena.vbo);
+        glGenBuffers(1, &arena.ebo);
+    }
+    glBindVertexArray(arena.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, arena.vbo);
+    glBufferData(GL_ARRAY_BUFFER, vertexData.size(), vertexData.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, arena.ebo);
+    if (arena.indexType == GL_UNSIGNED_SHORT) {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, shortIndices.size() * sizeof(uint16_t), shortIndices.data(),
+                     GL_STATIC_DRAW);
+    } else {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, arena.indices.size() * sizeof(unsigned int), arena.indices.data(),
+                     GL_STATIC_DRAW);
+    }
+    bindArenaVertices(arena);
+
+    printArenaReport(arena, positionError);
+}
+
+void destroyGeometryArena(GeometryArena& arena) {
+    glDeleteVertexArrays(1, &arena.vao);
+    glDeleteBuffers(1, &arena.vbo);
+    glDeleteBuffers(1, &arena.ebo);
+    arena = GeometryArena();
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Frustum.h"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+// The one vertex layout of the static scene: attribute 0 is the position,
+// attribute 1 the normal. Meshes authored without normals (room walls,
+// door frames) leave it zero; their shaders only read the position.
+struct Vertex {
+    glm::vec3 position;
+    glm::vec3 normal;
+};
+
+// A drawable range of the arena. Indices are local to their mesh's vertices,
+// so a draw adds baseVertex (glDrawElementsBaseVertex) and starts at
+// firstIndex in the shared index buffer.
+struct MeshRange {
+    GLint baseVertex;
+    unsigned int firstIndex;
+    GLsizei count;
+    Bounds bounds;      // Model space
+};
+
+// Every static mesh in one vertex buffer and one index buffer behind a single
+// VAO, so consecutive draws of different meshes change no GL state but their
+// offsets and can be merged into one multi-draw. Meshes are added on the CPU
+// first, then uploaded together; the registry is indexed by the id addMesh
+// returns.
+//
+// The GPU copy is packed at upload where that loses nothing visible:
+// half-float positions when every coordinate rounds within
+// HALF_POSITION_TOLERANCE, normals as GL_INT_2_10_10_10_REV and 16-bit
+// indices when no mesh has more than 65536 vertices. Draws have to index
+// with indexType.
+struct GeometryArena {
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<MeshRange> meshes;
+    std::vector<std::string> meshNames;
+    std::vector<unsigned int> partStarts;   // Where meshes and subranges begin and end in indices
+    unsigned int vao = 0;
+    unsigned int vbo = 0;
+    unsigned int ebo = 0;
+
+    // Layout of the uploaded buffers
+    GLenum positionType = GL_FLOAT;
+    GLenum normalType = GL_FLOAT;
+    GLenum indexType = GL_UNSIGNED_INT;
+    GLsizei vertexStride = sizeof(Vertex);
+    size_t normalOffset = sizeof(glm::vec3);
+};
+
+// World units; room coordinates go up to about 35, where a half is 1/32 apart
+const float HALF_POSITION_TOLERANCE = 1.0f / 256.0f;
+
+// Interleaved floats, position first, with a normal after it when stride is 6
+std::vector<Vertex> makeVertices(const float* data, size_t vertexCount, int stride);
+
+// name only labels the mesh in the upload report
+int addMesh(GeometryArena& arena, const std::string& name, const std::vector<Vertex>& vertices,
+            const unsigned int* indices, size_t indexCount);
+
+// Part of a mesh, firstIndex counted from the mesh's own first index, with
+// bounds over just that part
+MeshRange meshSubrange(GeometryArena& arena, int mesh, GLsizei count, unsigned int firstIndex);
+
+// Reorders every mesh for the post-transform vertex cache, for overdraw and
+// for vertex fetch (MeshOptimizer.h) and prints ACMR and ATVR before and
+// after. Triangles only move within the parts subranges were cut from, so
+// call it once they all have been taken, before uploading. Meshes listed in
+// blendedMeshes are left alone: they are drawn blended, where triangle order
+// is blending order. A reordering that doesn't lower a mesh's ACMR is
+// dropped too.
+void optimizeGeometryArena(GeometryArena& arena, const std::vector<int>& blendedMeshes);
+
+// Creates the GL objects, or refills them on later calls. compact = false
+// keeps the float layout and 32-bit indices, for comparison. Prints the
+// layout picked and each mesh's bytes in the float layout and as uploaded.
+void uploadGeometryArena(GeometryArena& arena, bool compact = true);
+// Bytes per index of GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+size_t indexTypeSize(GLenum type);
+// Points attributes 0 and 1 and the element buffer of the bound VAO at the
+// arena, in its uploaded layout
+void bindArenaVertices(const GeometryArena& arena);
+void destroyGeometryArena(GeometryArena& arena);
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// FNV-1a, chained through seed to hash several fields
+uint64_t hashBytes(const void* data, size_t size, uint64_t seed = 14695981039346656037ull);
@@ -0,0 +1,66 @@
+#include "Instancing.h"
+#include <glad/glad.h>
+#include <cstddef>
+
+static_assert(sizeof(InstanceData) == 148, "InstanceData must match the attributes in shaders/instancing.glsl");
+
+void initInstanceBatch(InstanceBatch& batch, const GeometryArena& arena, int mesh) {
+    batch.mesh = arena.meshes[mesh];
+    glGenVertexArrays(1, &batch.vao);
+    glGenBuffers(1, &batch.buffer);
+
+    glBindVertexArray(batch.vao);
+    bindArenaVertices(arena);
+
+    glBindBuffer(GL_ARRAY_BUFFER, batch.buffer);
+    for (unsigned int column = 0; column < 4; column++) {
+        unsigned int location = INSTANCE_MODEL_LOCATION + column;
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (void*)(offsetof(InstanceData, transform.model) + column * sizeof(glm::vec4)));
+        glVertexAttribDivisor(location, 1);
+        glEnableVertexAttribArray(location);
+    }
+    for (unsigned int column = 0; column < 3; column++) {
+        unsigned int location = INSTANCE_NORMAL_LOCATION + column;
+        glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (void*)(offsetof(InstanceData, transform.normalMatrix) + column * sizeof(glm::vec3)));
+        glVertexAttribDivisor(location, 1);
+        glEnableVertexAttribArray(location);
+    }
+    for (unsigned int slot = 0; slot < 3; slot++) {
+        unsigned int location = INSTANCE_MATERIAL_LOCATION + slot;
+        glVertexAttribIPointer(location, 4, GL_UNSIGNED_INT, sizeof(InstanceData),
+                               (void*)(offsetof(InstanceData, material) + slot * 4 * sizeof(uint32_t)));
+        glVertexAttribDivisor(location, 1);
+        glEnableVertexAttribArray(location);
+    }
+    glBindVertexArray(0);
+}
+
+void uploadInstances(InstanceBatch& batch) {
+    if (!batch.instances.empty()) {
+        updateNormalMatrices(&batch.instances[0].transform, batch.instances.size(), sizeof(InstanceData));
+    }
+    batch.bounds.min = glm::vec3(1e30f);
+    batch.bounds.max = glm::vec3(-1e30f);
+    for (const InstanceData& instance : batch.instances) {
+        Bounds bounds = transformBounds(batch.mesh.bounds, instance.transform.model);
+        batch.bounds.min = glm::min(batch.bounds.min, bounds.min);
+        batch.bounds.max = glm::max(batch.bounds.max, bounds.max);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, batch.buffer);
+    size_t bytes = batch.instances.size() * sizeof(InstanceData);
+    if (batch.instances.size() > batch.capacity) {
+        batch.capacity = batch.instances.size();
+        glBufferData(GL_ARRAY_BUFFER, bytes, batch.instances.data(), GL_STATIC_DRAW);
+    } else if (bytes > 0) {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, batch.instances.data());
+    }
+}
+
+void destroyInstanceBatch(InstanceBatch& batch) {
+    glDeleteVertexArrays(1, &batch.vao);
+    glDeleteBuffers(1, &batch.buffer);
+    batch = InstanceBatch();
+}
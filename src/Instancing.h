@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Frustum.h"
+#include "GeometryArena.h"
+#include "Transforms.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+// A material's std140 Material block as raw words; the largest block is 40
+// bytes. Instances carry one each, so objects sharing a program can still
+// differ in colour, noise scale or octave count.
+struct MaterialBlock {
+    uint32_t words[12];
+};
+
+// Vertex attributes of one instance (shaders/instancing.glsl): the model
+// matrix at locations 2-5, the normal matrix at 6-8 and the material block
+// at 9-11, read as integers so ints in the block come through bit for bit.
+struct InstanceData {
+    Transform transform;
+    MaterialBlock material;
+};
+
+const unsigned int INSTANCE_MODEL_LOCATION = 2;
+const unsigned int INSTANCE_NORMAL_LOCATION = 6;
+const unsigned int INSTANCE_MATERIAL_LOCATION = 9;
+
+// Instances of one mesh drawn with one program, a single
+// glDrawElementsInstancedBaseVertex. The VAO reads vertices and indices
+// from the geometry arena and the per-instance attributes from its own
+// buffer, which only grows.
+struct InstanceBatch {
+    MeshRange mesh;
+    std::vector<InstanceData> instances;
+    Bounds bounds;                  // World space, over every instance
+    unsigned int vao = 0;
+    unsigned int buffer = 0;
+    size_t capacity = 0;            // Instances the buffer has room for
+};
+
+void initInstanceBatch(InstanceBatch& batch, const GeometryArena& arena, int mesh);
+// Sends instances to the GPU and recomputes their normal matrices and the
+// bounds; call after editing them
+void uploadInstances(InstanceBatch& batch);
+void destroyInstanceBatch(InstanceBatch& batch);
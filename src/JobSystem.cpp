@@ -0,0 +1,115 @@
+#include "JobSystem.h"
+#include <algorithm>
+
+// Which system and deque the current thread works for, if any
+static thread_local JobSystem* workerSystem = NULL;
+static thread_local int workerIndex = -1;
+
+int defaultWorkerCount() {
+    return std::max(1, (int)std::thread::hardware_concurrency() - 1);
+}
+
+// Own deque from the back first, then steal from the front of the others
+static bool takeJob(JobSystem& system, int index, JobSystem::Job& job) {
+    int count = (int)system.queues.size();
+    if (index >= 0) {
+        JobSystem::Queue& own = *system.queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            system.queued--;
+            return true;
+        }
+    }
+    for (int i = 1; i <= count; i++) {
+        JobSystem::Queue& victim = *system.queues[(std::max(index, 0) + i) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            system.queued--;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void runJob(JobSystem::Job& job) {
+    job.run();
+    job.group->pending.fetch_sub(1, std::memory_order_release);
+}
+
+static void workerLoop(JobSystem& system, int index) {
+    workerSystem = &system;
+    workerIndex = index;
+
+    JobSystem::Job job;
+    for (;;) {
+        if (takeJob(system, index, job)) {
+            runJob(job);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(system.sleepMutex);
+        system.wake.wait(lock, [&]() { return !system.running || system.queued > 0; });
+        if (!system.running) return;
+    }
+}
+
+void startJobSystem(JobSystem& system, int workerCount) {
+    system.running = true;
+    system.queues.clear();
+    for (int i = 0; i < std::max(1, workerCount); i++) {
+        system.queues.push_back(std::unique_ptr<JobSystem::Queue>(new JobSystem::Queue()));
+    }
+    for (int i = 0; i < workerCount; i++) {
+        system.workers.push_back(std::thread(workerLoop, std::ref(system), i));
+    }
+}
+
+void stopJobSystem(JobSystem& system) {
+    {
+        std::lock_guard<std::mutex> lock(system.sleepMutex);
+        system.running = false;
+    }
+    system.wake.notify_all();
+    for (std::thread& worker : system.workers) {
+        worker.join();
+    }
+    system.workers.clear();
+    system.queues.clear();
+    system.queued = 0;
+}
+
+void submitJob(JobSystem& system, JobGroup& group, std::function<void()> job) {
+    group.pending.fetch_add(1, std::memory_order_relaxed);
+
+    int index = workerSystem == &system ? workerIndex
+                                        : (int)(system.nextQueue++ % system.queues.size());
+    {
+        JobSystem::Queue& queue = *system.queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(JobSystem::Job{std::move(job), &group});
+    }
+    system.queued++;
+
+    // Taking the lock orders this with a worker checking queued before it sleeps
+    { std::lock_guard<std::mutex> lock(system.sleepMutex); }
+    system.wake.notify_one();
+}
+
+bool isGroupDone(const JobGroup& group) {
+    return group.pending.load(std::memory_order_acquire) == 0;
+}
+
+void waitForGroup(JobSystem& system, JobGroup& group) {
+    int index = workerSystem == &system ? workerIndex : -1;
+    JobSystem::Job job;
+    while (!isGroupDone(group)) {
+        if (takeJob(system, index, job)) {
+            runJob(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
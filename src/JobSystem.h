@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool. Every worker owns a deque: jobs it submits go on
+// the back and it pops from the back (newest first, still warm in cache);
+// when its own deque runs dry it steals from the front of the others'. Jobs
+// submitted from other threads are dealt round-robin across the deques.
+// Callers track completion through a JobGroup.
+struct JobGroup {
+    std::atomic<int> pending{0};
+};
+
+struct JobSystem {
+    struct Job {
+        std::function<void()> run;
+        JobGroup* group;
+    };
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<int> queued{0};
+    std::atomic<unsigned int> nextQueue{0};
+    bool running = false;
+};
+
+// All cores but one, which is left to the render thread
+int defaultWorkerCount();
+
+// With no workers, jobs only run inside waitForGroup
+void startJobSystem(JobSystem& system, int workerCount);
+// Jobs still queued are dropped, their groups never complete
+void stopJobSystem(JobSystem& system);
+
+void submitJob(JobSystem& system, JobGroup& group, std::function<void()> job);
+
+bool isGroupDone(const JobGroup& group);
+
+// Runs queued jobs on the calling thread until group completes
+void waitForGroup(JobSystem& system, JobGroup& group);
@@ -0,0 +1,29 @@
+#include "Lod.h"
+#include <cmath>
+#include <limits>
+
+float projectedRadius(const glm::vec3& center, float radius, const glm::vec3& eye, const glm::mat4& projection,
+                      float viewportHeight) {
+    float distance = glm::length(center - eye);
+    if (distance <= radius) {
+        return std::numeric_limits<float>::infinity();
+    }
+    // projection[1][1] is 1 / tan(fovy / 2)
+    return radius * projection[1][1] * 0.5f * viewportHeight / distance;
+}
+
+int selectLod(int current, float radius, const float* minRadius, int levelCount, float hysteresis) {
+    int level = current;
+    while (level + 1 < levelCount && radius >= minRadius[level + 1]) {
+        level++;
+    }
+    while (level > 0 && radius < minRadius[level] * (1.0f - hysteresis)) {
+        level--;
+    }
+    return level;
+}
+
+float segmentsMaxRadius(unsigned int segments, float maxError) {
+    // A chord spanning 2 pi / segments sits r (1 - cos(pi / segments)) inside the circle
+    return maxError / (1.0f - std::cos(3.14159265359f / segments));
+}
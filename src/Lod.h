@@ -0,0 +1,22 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// Level-of-detail selection by projected size. Levels are ordered coarsest
+// first and level i is used from minRadius[i] pixels of projected radius up;
+// minRadius[0] is 0.
+
+// Radius in pixels of a sphere of the given world radius seen from eye, for
+// a perspective projection and a viewport viewportHeight pixels tall.
+// Infinite when the eye is inside the sphere.
+float projectedRadius(const glm::vec3& center, float radius, const glm::vec3& eye, const glm::mat4& projection,
+                      float viewportHeight);
+
+// The level for a projected radius, starting from the current one. A level
+// is only dropped once the radius falls hysteresis (a fraction) below where
+// it starts, so objects near a threshold don't flip every frame.
+int selectLod(int current, float radius, const float* minRadius, int levelCount, float hysteresis);
+
+// Projected radius from which a circle drawn with the given number of
+// segments strays more than maxError pixels from the true silhouette
+float segmentsMaxRadius(unsigned int segments, float maxError);
@@ -0,0 +1,239 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+VertexCacheStats analyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount) {
+    // A vertex is still cached if fewer than VERTEX_CACHE_SIZE misses happened
+    // since its own; time only advances on a miss
+    std::vector<unsigned int> missTime(vertexCount, 0);
+    unsigned int time = VERTEX_CACHE_SIZE + 1;
+    unsigned int misses = 0;
+    for (size_t i = 0; i < indexCount; i++) {
+        unsigned int v = indices[i];
+        if (time - missTime[v] > VERTEX_CACHE_SIZE) {
+            missTime[v] = time++;
+            misses++;
+        }
+    }
+
+    VertexCacheStats stats;
+    stats.acmr = indexCount >= 3 ? misses / (indexCount / 3.0f) : 0.0f;
+    stats.atvr = vertexCount > 0 ? misses / (float)vertexCount : 0.0f;
+    return stats;
+}
+
+// Forsyth's scoring: the LRU cache it models, the score of the three
+// vertices of the last triangle, and how strongly vertices with few
+// triangles left are preferred
+static const int FORSYTH_CACHE_SIZE = 32;
+static const float CACHE_DECAY_POWER = 1.5f;
+static const float LAST_TRIANGLE_SCORE = 0.75f;
+static const float VALENCE_BOOST_SCALE = 2.0f;
+static const float VALENCE_BOOST_POWER = 0.5f;
+
+static float vertexScore(int cachePosition, unsigned int remaining) {
+    if (remaining == 0) return -1.0f;
+    float score = 0.0f;
+    if (cachePosition >= 0) {
+        score = cachePosition < 3
+                    ? LAST_TRIANGLE_SCORE
+                    : std::pow(1.0f - (cachePosition - 3) / (float)(FORSYTH_CACHE_SIZE - 3), CACHE_DECAY_POWER);
+    }
+    return score + VALENCE_BOOST_SCALE * std::pow((float)remaining, -VALENCE_BOOST_POWER);
+}
+
+void optimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount) {
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) return;
+
+    // Triangles of each vertex not emitted yet, in one array: the ones of
+    // vertex v start at first[v], remaining[v] of them
+    std::vector<unsigned int> remaining(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; i++) remaining[indices[i]]++;
+    std::vector<unsigned int> first(vertexCount, 0);
+    for (size_t v = 1; v < vertexCount; v++) first[v] = first[v - 1] + remaining[v - 1];
+    std::vector<unsigned int> adjacency(triangleCount * 3);
+    std::vector<unsigned int> filled(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; i++) {
+        unsigned int v = indices[i];
+        adjacency[first[v] + filled[v]++] = (unsigned int)(i / 3);
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> scores(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) scores[v] = vertexScore(-1, remaining[v]);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<unsigned int> output;
+    output.reserve(triangleCount * 3);
+    std::vector<unsigned int> cache, newCache;
+    size_t cursor = 0;      // Triangles before it are all emitted
+    int best = -1;
+
+    while (output.size() < triangleCount * 3) {
+        // Nothing left around the cache: restart at the first triangle left
+        if (best < 0) {
+            while (emitted[cursor]) cursor++;
+            best = (int)cursor;
+        }
+        const unsigned int* triangle = indices + best * 3;
+        emitted[best] = true;
+        output.insert(output.end(), triangle, triangle + 3);
+
+        for (int k = 0; k < 3; k++) {
+            unsigned int v = triangle[k];
+            unsigned int* begin = &adjacency[first[v]];
+            unsigned int* end = begin + remaining[v];
+            *std::find(begin, end, (unsigned int)best) = end[-1];
+            remaining[v]--;
+        }
+
+        // The triangle's vertices move to the front; the ones pushed past the
+        // end leave the cache but still need their scores lowered
+        newCache.assign(triangle, triangle + 3);
+        for (unsigned int v : cache) {
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2]) newCache.push_back(v);
+        }
+        for (size_t i = 0; i < newCache.size(); i++) {
+            unsigned int v = newCache[i];
+            cachePosition[v] = i < (size_t)FORSYTH_CACHE_SIZE ? (int)i : -1;
+            scores[v] = vertexScore(cachePosition[v], remaining[v]);
+        }
+
+        // Only triangles around the touched vertices changed score
+        best = -1;
+        float bestScore = -1.0f;
+        for (unsigned int v : newCache) {
+            for (unsigned int i = 0; i < remaining[v]; i++) {
+                unsigned int t = adjacency[first[v] + i];
+                float score = scores[indices[t * 3]] + scores[indices[t * 3 + 1]] + scores[indices[t * 3 + 2]];
+                if (score > bestScore) {
+                    bestScore = score;
+                    best = (int)t;
+                }
+            }
+        }
+        if (newCache.size() > (size_t)FORSYTH_CACHE_SIZE) newCache.resize(FORSYTH_CACHE_SIZE);
+        cache.swap(newCache);
+    }
+
+    std::copy(output.begin(), output.end(), indices);
+}
+
+// Cache misses (0 to 3) of a triangle, through the same FIFO as
+// analyzeVertexCache. Adding VERTEX_CACHE_SIZE + 1 to time empties the cache.
+static unsigned int triangleMisses(const unsigned int* triangle, std::vector<unsigned int>& missTime,
+                                   unsigned int& time) {
+    unsigned int misses = 0;
+    for (int k = 0; k < 3; k++) {
+        if (time - missTime[triangle[k]] > VERTEX_CACHE_SIZE) {
+            missTime[triangle[k]] = time++;
+            misses++;
+        }
+    }
+    return misses;
+}
+
+void optimizeOverdraw(unsigned int* indices, size_t indexCount, const Vertex* vertices, size_t vertexCount,
+                      float threshold) {
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount < 2) return;
+
+    // Hard boundaries: triangles the cache optimised order starts afresh at,
+    // all three vertices missing
+    std::vector<unsigned int> missTime(vertexCount, 0);
+    unsigned int time = VERTEX_CACHE_SIZE + 1;
+    std::vector<unsigned int> misses(triangleCount);
+    std::vector<bool> starts(triangleCount, false);
+    for (size_t t = 0; t < triangleCount; t++) {
+        misses[t] = triangleMisses(indices + t * 3, missTime, time);
+        starts[t] = t == 0 || misses[t] == 3;
+    }
+
+    // Soft boundaries: within each hard cluster, a cut as soon as the part
+    // so far, from an empty cache, is within threshold of the cluster's ACMR
+    std::vector<bool> soft = starts;
+    for (size_t begin = 0; begin < triangleCount;) {
+        size_t end = begin + 1;
+        while (end < triangleCount && !starts[end]) end++;
+        unsigned int clusterMisses = 0;
+        for (size_t t = begin; t < end; t++) clusterMisses += misses[t];
+        float clusterAcmr = clusterMisses / (float)(end - begin);
+
+        for (size_t start = begin; start < end;) {
+            time += VERTEX_CACHE_SIZE + 1;
+            unsigned int partMisses = 0;
+            size_t t = start;
+            for (; t + 1 < end; t++) {
+                partMisses += triangleMisses(indices + t * 3, missTime, time);
+                if (partMisses <= threshold * clusterAcmr * (t - start + 1)) break;
+            }
+            start = t + 1;
+            if (start < end) soft[start] = true;
+        }
+        begin = end;
+    }
+
+    // Area weighted centroid and normal of every cluster, and of the mesh
+    struct Cluster {
+        size_t begin, end;
+        glm::vec3 centroid, normal;
+        float area;
+        float sortKey;
+    };
+    std::vector<Cluster> clusters;
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    for (size_t t = 0; t < triangleCount; t++) {
+        if (soft[t]) clusters.push_back({t, t, glm::vec3(0.0f), glm::vec3(0.0f), 0.0f, 0.0f});
+        Cluster& cluster = clusters.back();
+        cluster.end = t + 1;
+
+        const glm::vec3& a = vertices[indices[t * 3]].position;
+        const glm::vec3& b = vertices[indices[t * 3 + 1]].position;
+        const glm::vec3& c = vertices[indices[t * 3 + 2]].position;
+        glm::vec3 normal = glm::cross(b - a, c - a);
+        float area = glm::length(normal);
+        glm::vec3 center = (a + b + c) / 3.0f;
+        cluster.centroid += center * area;
+        cluster.normal += normal;
+        cluster.area += area;
+        meshCentroid += center * area;
+        meshArea += area;
+    }
+    if (meshArea > 0.0f) meshCentroid /= meshArea;
+    for (Cluster& cluster : clusters) {
+        if (cluster.area <= 0.0f) continue;
+        glm::vec3 centroid = cluster.centroid / cluster.area;
+        float length = glm::length(cluster.normal);
+        cluster.sortKey = length > 0.0f ? glm::dot(centroid - meshCentroid, cluster.normal / length) : 0.0f;
+    }
+
+    std::stable_sort(clusters.begin(), clusters.end(),
+                     [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+    std::vector<unsigned int> output;
+    output.reserve(triangleCount * 3);
+    for (const Cluster& cluster : clusters) {
+        output.insert(output.end(), indices + cluster.begin * 3, indices + cluster.end * 3);
+    }
+    std::copy(output.begin(), output.end(), indices);
+}
+
+void optimizeVertexFetch(Vertex* vertices, size_t vertexCount, unsigned int* indices, size_t indexCount) {
+    const unsigned int UNUSED = ~0u;
+    std::vector<unsigned int> remap(vertexCount, UNUSED);
+    unsigned int next = 0;
+    for (size_t i = 0; i < indexCount; i++) {
+        unsigned int& v = remap[indices[i]];
+        if (v == UNUSED) v = next++;
+        indices[i] = v;
+    }
+    for (unsigned int& v : remap) {
+        if (v == UNUSED) v = next++;
+    }
+
+    std::vector<Vertex> reordered(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) reordered[remap[v]] = vertices[v];
+    std::copy(reordered.begin(), reordered.end(), vertices);
+}
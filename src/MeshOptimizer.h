@@ -0,0 +1,38 @@
+#pragma once
+
+#include "GeometryArena.h"
+#include <cstddef>
+
+// Index and vertex reordering for triangle lists, run once at setup. Indices
+// are local to a mesh of vertexCount vertices; every function works in place.
+
+// Post-transform cache the statistics simulate: a FIFO, like most hardware
+const unsigned int VERTEX_CACHE_SIZE = 16;
+
+// Vertex shader invocations under the simulated cache, per triangle (ACMR,
+// 0.5 at best for a large regular grid, 3 at worst) and per vertex of the
+// mesh (ATVR, 1 at best)
+struct VertexCacheStats {
+    float acmr;
+    float atvr;
+};
+
+VertexCacheStats analyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount);
+
+// Tom Forsyth's "Linear-Speed Vertex Cache Optimisation": triangles are
+// emitted greedily by a score that favours vertices recently used (an LRU
+// cache model) and vertices with few triangles left, so the last triangles
+// of a vertex aren't stranded.
+void optimizeVertexCache(unsigned int* indices, size_t indexCount, size_t vertexCount);
+
+// View-independent overdraw ordering (Sander, Nehab and Barczak, "Fast
+// Triangle Reordering for Vertex Locality and Reduced Overdraw"): the cache
+// optimised order is cut into clusters wherever that costs at most threshold
+// times the ACMR, and the clusters are sorted so the ones facing most away
+// from the mesh centre, which tend to occlude the rest, draw first.
+void optimizeOverdraw(unsigned int* indices, size_t indexCount, const Vertex* vertices, size_t vertexCount,
+                      float threshold);
+
+// Renumbers vertices in the order the indices first use them, so vertex
+// fetch walks the buffer forward. Unreferenced vertices move to the end.
+void optimizeVertexFetch(Vertex* vertices, size_t vertexCount, unsigned int* indices, size_t indexCount);
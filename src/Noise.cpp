@@ -0,0 +1,226 @@
+#include "Noise.h"
+
+static glm::vec3 mod289(const glm::vec3& x) { return x - glm::floor(x * (1.0f / 289.0f)) * 289.0f; }
+static glm::vec4 mod289(const glm::vec4& x) { return x - glm::floor(x * (1.0f / 289.0f)) * 289.0f; }
+static glm::vec4 permute(const glm::vec4& x) { return mod289(((x * 34.0f) + 1.0f) * x); }
+static glm::vec4 taylorInvSqrt(const glm::vec4& r) { return 1.79284291400159f - 0.85373472095314f * r; }
+static glm::vec3 fade(const glm::vec3& t) { return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f); }
+
+float perlinNoise(const glm::vec3& P) {
+    glm::vec3 i0 = mod289(glm::floor(P));
+    glm::vec3 i1 = mod289(i0 + glm::vec3(1.0f));
+    glm::vec3 f0 = glm::fract(P);
+    glm::vec3 f1 = f0 - glm::vec3(1.0f);
+
+    glm::vec4 ix = glm::vec4(i0.x, i1.x, i0.x, i1.x);
+    glm::vec4 iy = glm::vec4(i0.y, i0.y, i1.y, i1.y);
+    glm::vec4 iz0 = glm::vec4(i0.z);
+    glm::vec4 iz1 = glm::vec4(i1.z);
+
+    glm::vec4 ixy = permute(permute(ix) + iy);
+    glm::vec4 ixy0 = permute(ixy + iz0);
+    glm::vec4 ixy1 = permute(ixy + iz1);
+
+    glm::vec4 gx0 = ixy0 * (1.0f / 7.0f);
+    glm::vec4 gy0 = glm::fract(glm::floor(gx0) * (1.0f / 7.0f)) - 0.5f;
+    gx0 = glm::fract(gx0);
+    glm::vec4 gz0 = glm::vec4(0.5f) - glm::abs(gx0) - glm::abs(gy0);
+    glm::vec4 sz0 = glm::step(gz0, glm::vec4(0.0f));
+    gx0 -= sz0 * (glm::step(glm::vec4(0.0f), gx0) - 0.5f);
+    gy0 -= sz0 * (glm::step(glm::vec4(0.0f), gy0) - 0.5f);
+
+    glm::vec4 gx1 = ixy1 * (1.0f / 7.0f);
+    glm::vec4 gy1 = glm::fract(glm::floor(gx1) * (1.0f / 7.0f)) - 0.5f;
+    gx1 = glm::fract(gx1);
+    glm::vec4 gz1 = glm::vec4(0.5f) - glm::abs(gx1) - glm::abs(gy1);
+    glm::vec4 sz1 = glm::step(gz1, glm::vec4(0.0f));
+    gx1 -= sz1 * (glm::step(glm::vec4(0.0f), gx1) - 0.5f);
+    gy1 -= sz1 * (glm::step(glm::vec4(0.0f), gy1) - 0.5f);
+
+    glm::vec3 g000 = glm::vec3(gx0.x, gy0.x, gz0.x);
+    glm::vec3 g100 = glm::vec3(gx0.y, gy0.y, gz0.y);
+    glm::vec3 g010 = glm::vec3(gx0.z, gy0.z, gz0.z);
+    glm::vec3 g110 = glm::vec3(gx0.w, gy0.w, gz0.w);
+    glm::vec3 g001 = glm::vec3(gx1.x, gy1.x, gz1.x);
+    glm::vec3 g101 = glm::vec3(gx1.y, gy1.y, gz1.y);
+    glm::vec3 g011 = glm::vec3(gx1.z, gy1.z, gz1.z);
+    glm::vec3 g111 = glm::vec3(gx1.w, gy1.w, gz1.w);
+
+    glm::vec4 norm0 = taylorInvSqrt(glm::vec4(glm::dot(g000, g000), glm::dot(g010, g010), glm::dot(g100, g100), glm::dot(g110, g110)));
+    g000 *= norm0.x;
+    g010 *= norm0.y;
+    g100 *= norm0.z;
+    g110 *= norm0.w;
+    glm::vec4 norm1 = taylorInvSqrt(glm::vec4(glm::dot(g001, g001), glm::dot(g011, g011), glm::dot(g101, g101), glm::dot(g111, g111)));
+    g001 *= norm1.x;
+    g011 *= norm1.y;
+    g101 *= norm1.z;
+    g111 *= norm1.w;
+
+    float n000 = glm::dot(g000, f0);
+    float n100 = glm::dot(g100, glm::vec3(f1.x, f0.y, f0.z));
+    float n010 = glm::dot(g010, glm::vec3(f0.x, f1.y, f0.z));
+    float n110 = glm::dot(g110, glm::vec3(f1.x, f1.y, f0.z));
+    float n001 = glm::dot(g001, glm::vec3(f0.x, f0.y, f1.z));
+    float n101 = glm::dot(g101, glm::vec3(f1.x, f0.y, f1.z));
+    float n011 = glm::dot(g011, glm::vec3(f0.x, f1.y, f1.z));
+    float n111 = glm::dot(g111, f1);
+
+    glm::vec3 fade_xyz = fade(f0);
+    glm::vec4 n_z = glm::mix(glm::vec4(n000, n100, n010, n110), glm::vec4(n001, n101, n011, n111), fade_xyz.z);
+    glm::vec2 n_yz = glm::mix(glm::vec2(n_z.x, n_z.y), glm::vec2(n_z.z, n_z.w), fade_xyz.y);
+    float n_xyz = glm::mix(n_yz.x, n_yz.y, fade_xyz.x);
+    return 2.2f * n_xyz;
+}
+
+float simplexNoise(const glm::vec3& v) {
+    const glm::vec2 C = glm::vec2(1.0f / 6.0f, 1.0f / 3.0f);
+
+    // First corner
+    glm::vec3 i = glm::floor(v + glm::dot(v, glm::vec3(C.y)));
+    glm::vec3 x0 = v - i + glm::dot(i, glm::vec3(C.x));
+
+    // Other corners
+    glm::vec3 g = glm::step(glm::vec3(x0.y, x0.z, x0.x), x0);
+    glm::vec3 l = 1.0f - g;
+    glm::vec3 i1 = glm::min(g, glm::vec3(l.z, l.x, l.y));
+    glm::vec3 i2 = glm::max(g, glm::vec3(l.z, l.x, l.y));
+
+    glm::vec3 x1 = x0 - i1 + C.x;
+    glm::vec3 x2 = x0 - i2 + C.y;
+    glm::vec3 x3 = x0 - 0.5f;
+
+    // Permutations
+    i = mod289(i);
+    glm::vec4 p = permute(permute(permute(
+        i.z + glm::vec4(0.0f, i1.z, i2.z, 1.0f))
+        + i.y + glm::vec4(0.0f, i1.y, i2.y, 1.0f))
+        + i.x + glm::vec4(0.0f, i1.x, i2.x, 1.0f));
+
+    // Gradients: 7x7 points over a square, mapped onto an octahedron.
+    // ns = n_ * D.wyz - D.xzx with D = (0, 0.5, 1, 2)
+    float n_ = 0.142857142857f;
+    glm::vec3 ns = glm::vec3(n_ * 2.0f, n_ * 0.5f - 1.0f, n_ * 1.0f);
+
+    glm::vec4 j = p - 49.0f * glm::floor(p * ns.z * ns.z);
+
+    glm::vec4 x_ = glm::floor(j * ns.z);
+    glm::vec4 y_ = glm::floor(j - 7.0f * x_);
+
+    glm::vec4 x = x_ * ns.x + ns.y;
+    glm::vec4 y = y_ * ns.x + ns.y;
+    glm::vec4 h = 1.0f - glm::abs(x) - glm::abs(y);
+
+    glm::vec4 b0 = glm::vec4(x.x, x.y, y.x, y.y);
+    glm::vec4 b1 = glm::vec4(x.z, x.w, y.z, y.w);
+
+    glm::vec4 s0 = glm::floor(b0) * 2.0f + 1.0f;
+    glm::vec4 s1 = glm::floor(b1) * 2.0f + 1.0f;
+    glm::vec4 sh = -glm::step(h, glm::vec4(0.0f));
+
+    glm::vec4 a0 = glm::vec4(b0.x, b0.z, b0.y, b0.w) + glm::vec4(s0.x, s0.z, s0.y, s0.w) * glm::vec4(sh.x, sh.x, sh.y, sh.y);
+    glm::vec4 a1 = glm::vec4(b1.x, b1.z, b1.y, b1.w) + glm::vec4(s1.x, s1.z, s1.y, s1.w) * glm::vec4(sh.z, sh.z, sh.w, sh.w);
+
+    glm::vec3 p0 = glm::vec3(a0.x, a0.y, h.x);
+    glm::vec3 p1 = glm::vec3(a0.z, a0.w, h.y);
+    glm::vec3 p2 = glm::vec3(a1.x, a1.y, h.z);
+    glm::vec3 p3 = glm::vec3(a1.z, a1.w, h.w);
+
+    // Normalise gradients
+    glm::vec4 norm = taylorInvSqrt(glm::vec4(glm::dot(p0, p0), glm::dot(p1, p1), glm::dot(p2, p2), glm::dot(p3, p3)));
+    p0 *= norm.x;
+    p1 *= norm.y;
+    p2 *= norm.z;
+    p3 *= norm.w;
+
+    // Mix final noise value
+    glm::vec4 m = glm::max(0.6f - glm::vec4(glm::dot(x0, x0), glm::dot(x1, x1), glm::dot(x2, x2), glm::dot(x3, x3)), 0.0f);
+    m = m * m;
+    return 42.0f * glm::dot(m * m, glm::vec4(glm::dot(p0, x0), glm::dot(p1, x1), glm::dot(p2, x2), glm::dot(p3, x3)));
+}
+
+float fbmNoise(const glm::vec3& pos, int octaves) {
+    float amplitude = 0.5f;
+    float frequency = 1.0f;
+    float noiseSum = 0.0f;
+    float amplitudeSum = 0.0f;
+
+    for (int i = 0; i < octaves; i++) {
+        noiseSum += amplitude * perlinNoise(pos * frequency);
+        amplitudeSum += amplitude;
+        amplitude *= 0.5f;
+        frequency *= 2.0f;
+    }
+
+    return noiseSum / amplitudeSum;
+}
+
+float turbulenceNoise(const glm::vec3& pos, int octaves) {
+    float sum = 0.0f;
+    float frequency = 1.0f;
+    float amplitude = 1.0f;
+    float maxValue = 0.0f;
+
+    for (int i = 0; i < octaves; i++) {
+        sum += glm::abs(perlinNoise(pos * frequency)) * amplitude;
+        maxValue += amplitude;
+        amplitude *= 0.5f;
+        frequency *= 2.0f;
+    }
+
+    return sum / maxValue;
+}
+
+float multifractalNoise(const glm::vec3& pos, float lacunarity, int octaves) {
+    float value = 1.0f;
+    float frequency = 1.0f;
+    float weight = 1.0f;
+
+    for (int i = 0; i < octaves; i++) {
+        value *= (weight * simplexNoise(pos * frequency) + 1.0f);
+        frequency *= lacunarity;
+        weight = glm::clamp(value, 0.0f, 1.0f);
+    }
+
+    return value;
+}
+
+static glm::vec3 hash3(glm::vec3 p) {
+    p = glm::vec3(glm::dot(p, glm::vec3(127.1f, 311.7f, 74.7f)),
+                  glm::dot(p, glm::vec3(269.5f, 183.3f, 246.1f)),
+                  glm::dot(p, glm::vec3(113.5f, 271.9f, 124.6f)));
+    return -1.0f + 2.0f * glm::fract(glm::sin(p) * 43758.5453123f);
+}
+
+float cellularNoise(const glm::vec3& p) {
+    glm::vec3 i_p = glm::floor(p);
+    glm::vec3 f_p = glm::fract(p);
+    float min_dist = 1.0f;
+
+    for (int k = -1; k <= 1; k++)
+    for (int j = -1; j <= 1; j++)
+    for (int i = -1; i <= 1; i++) {
+        glm::vec3 neighbor = glm::vec3((float)i, (float)j, (float)k);
+        glm::vec3 point = hash3(i_p + neighbor);
+        point = 0.5f + 0.5f * glm::sin(point * 6.2831853f);
+        glm::vec3 diff = neighbor + point - f_p;
+        float dist = glm::length(diff);
+        min_dist = glm::min(min_dist, dist);
+    }
+    return min_dist;
+}
+
+static float hash2(const glm::vec2& co) {
+    return glm::fract(glm::sin(glm::dot(co, glm::vec2(12.9898f, 78.233f))) * 43758.5453f);
+}
+
+float valueNoise(const glm::vec2& p) {
+    glm::vec2 ip = glm::floor(p);
+    glm::vec2 u = glm::fract(p);
+    u = u * u * (3.0f - 2.0f * u);
+
+    float res = glm::mix(
+        glm::mix(hash2(ip), hash2(ip + glm::vec2(1.0f, 0.0f)), u.x),
+        glm::mix(hash2(ip + glm::vec2(0.0f, 1.0f)), hash2(ip + glm::vec2(1.0f, 1.0f)), u.x), u.y);
+    return res * res;
+}
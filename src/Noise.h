@@ -0,0 +1,56 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+
+// C++ ports of the GLSL noise library in shaders/noise/, used to
+// bake noise fields on the CPU. Each one follows its GLSL original line by
+// line so baked and analytic results agree up to float precision.
+
+// "cnoise" in noise/perlin.glsl: classic Perlin
+float perlinNoise(const glm::vec3& P);
+
+// "snoise" in noise/simplex.glsl: simplex noise
+float simplexNoise(const glm::vec3& v);
+
+// "fbm" in noise/fractal.glsl: octaves of Perlin (four in the shader), normalized
+float fbmNoise(const glm::vec3& pos, int octaves = 4);
+
+// "turbulence" in noise/fractal.glsl: octaves of |Perlin| (four in the
+// shader), normalized
+float turbulenceNoise(const glm::vec3& pos, int octaves = 4);
+
+// "multifractal" in noise/fractal.glsl (the unused H argument is dropped)
+float multifractalNoise(const glm::vec3& pos, float lacunarity, int octaves);
+
+// "cellular" in noise/cellular.glsl: distance to the nearest Worley point
+float cellularNoise(const glm::vec3& p);
+
+// "valueNoise" in noise/value.glsl: squared, smoothstepped 2D value noise
+float valueNoise(const glm::vec2& p);
+
+// Batched versions over structure-of-arrays input: point i is
+// (x[i], y[i], z[i]) and its value is written to out[i]. They run on the
+// widest backend the CPU supports; the SIMD backends match the scalar ports
+// up to float rounding (cellular swaps its smooth sin for a polynomial).
+enum NoiseBackend {
+    NOISE_SCALAR,
+    NOISE_SSE41,   // 4 points per instruction
+    NOISE_AVX2,    // 8 points per instruction
+    NOISE_BACKEND_COUNT
+};
+
+const char* noiseBackendName(NoiseBackend backend);
+bool noiseBackendSupported(NoiseBackend backend);
+NoiseBackend noiseBackend();
+// Forces a backend, for comparisons; unsupported ones are ignored
+void setNoiseBackend(NoiseBackend backend);
+
+void perlinNoiseBatch(const float* x, const float* y, const float* z, float* out, size_t count);
+void simplexNoiseBatch(const float* x, const float* y, const float* z, float* out, size_t count);
+void fbmNoiseBatch(const float* x, const float* y, const float* z, float* out, size_t count, int octaves = 4);
+void turbulenceNoiseBatch(const float* x, const float* y, const float* z, float* out, size_t count, int octaves = 4);
+void multifractalNoiseBatch(const float* x, const float* y, const float* z, float* out, size_t count,
+                            float lacunarity, int octaves);
+void cellularNoiseBatch(const float* x, const float* y, const float* z, float* out, size_t count);
+void valueNoiseBatch(const float* x, const float* y, float* out, size_t count);
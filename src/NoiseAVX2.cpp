@@ -0,0 +1,53 @@
+#include "NoiseBatch.h"
+
+#ifdef NOISE_X86
+#include <immintrin.h>
+#include <cmath>
+
+// Compiled for AVX2 regardless of the command line flags; only called after
+// the CPU check in NoiseBatch.cpp. FMA is left off on purpose: contracting
+// a * b + c would round differently from the scalar ports.
+#pragma GCC target("avx2")
+
+namespace {
+
+struct V {
+    __m256 v;
+    V() {}
+    V(__m256 v) : v(v) {}
+    V(float f) : v(_mm256_set1_ps(f)) {}
+};
+
+const int LANES = 8;
+
+inline V operator+(V a, V b) { return _mm256_add_ps(a.v, b.v); }
+inline V operator-(V a, V b) { return _mm256_sub_ps(a.v, b.v); }
+inline V operator*(V a, V b) { return _mm256_mul_ps(a.v, b.v); }
+inline V operator/(V a, V b) { return _mm256_div_ps(a.v, b.v); }
+inline V operator-(V a) { return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)); }
+
+inline V vload(const float* p) { return _mm256_loadu_ps(p); }
+inline void vstore(float* p, V a) { _mm256_storeu_ps(p, a.v); }
+inline V vfloor(V a) { return _mm256_floor_ps(a.v); }
+inline V vabs(V a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v); }
+inline V vmin(V a, V b) { return _mm256_min_ps(a.v, b.v); }
+inline V vmax(V a, V b) { return _mm256_max_ps(a.v, b.v); }
+inline V vsqrt(V a) { return _mm256_sqrt_ps(a.v); }
+// GLSL step: x < edge ? 0 : 1
+inline V vstep(V edge, V x) { return _mm256_and_ps(_mm256_cmp_ps(x.v, edge.v, _CMP_NLT_UQ), _mm256_set1_ps(1.0f)); }
+
+inline V vsinExact(V a) {
+    alignas(32) float lanes[LANES];
+    _mm256_store_ps(lanes, a.v);
+    for (int i = 0; i < LANES; i++) lanes[i] = std::sin(lanes[i]);
+    return _mm256_load_ps(lanes);
+}
+
+#include "NoiseKernels.inl"
+
+}
+
+const NoiseBatchKernels noiseKernelsAVX2 = {
+    perlinBatch, simplexBatch, fbmBatch, turbulenceBatch, multifractalBatch, cellularBatch, valueBatch
+};
+#endif
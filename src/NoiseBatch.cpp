@@ -0,0 +1,104 @@
+#include "Noise.h"
+#include "NoiseBatch.h"
+
+static void perlinScalar(const float* x, const float* y, const float* z, float* out, size_t count) {
+    for (size_t i = 0; i < count; i++) out[i] = perlinNoise(glm::vec3(x[i], y[i], z[i]));
+}
+
+static void simplexScalar(const float* x, const float* y, const float* z, float* out, size_t count) {
+    for (size_t i = 0; i < count; i++) out[i] = simplexNoise(glm::vec3(x[i], y[i], z[i]));
+}
+
+static void fbmScalar(const float* x, const float* y, const float* z, float* out, size_t count, int octaves) {
+    for (size_t i = 0; i < count; i++) out[i] = fbmNoise(glm::vec3(x[i], y[i], z[i]), octaves);
+}
+
+static void turbulenceScalar(const float* x, const float* y, const float* z, float* out, size_t count, int octaves) {
+    for (size_t i = 0; i < count; i++) out[i] = turbulenceNoise(glm::vec3(x[i], y[i], z[i]), octaves);
+}
+
+static void multifractalScalar(const float* x, const float* y, const float* z, float* out, size_t count,
+                               float lacunarity, int octaves) {
+    for (size_t i = 0; i < count; i++) out[i] = multifractalNoise(glm::vec3(x[i], y[i], z[i]), lacunarity, octaves);
+}
+
+static void cellularScalar(const float* x, const float* y, const float* z, float* out, size_t count) {
+    for (size_t i = 0; i < count; i++) out[i] = cellularNoise(glm::vec3(x[i], y[i], z[i]));
+}
+
+static void valueScalar(const float* x, const float* y, float* out, size_t count) {
+    for (size_t i = 0; i < count; i++) out[i] = valueNoise(glm::vec2(x[i], y[i]));
+}
+
+static const NoiseBatchKernels noiseKernelsScalar = {
+    perlinScalar, simplexScalar, fbmScalar, turbulenceScalar, multifractalScalar, cellularScalar, valueScalar
+};
+
+const char* noiseBackendName(NoiseBackend backend) {
+    static const char* names[NOISE_BACKEND_COUNT] = {"scalar", "sse4.1", "avx2"};
+    return names[backend];
+}
+
+bool noiseBackendSupported(NoiseBackend backend) {
+#ifdef NOISE_X86
+    __builtin_cpu_init();
+    if (backend == NOISE_SSE41) return __builtin_cpu_supports("sse4.1");
+    if (backend == NOISE_AVX2) return __builtin_cpu_supports("avx2");
+#endif
+    return backend == NOISE_SCALAR;
+}
+
+static NoiseBackend detectNoiseBackend() {
+    if (noiseBackendSupported(NOISE_AVX2)) return NOISE_AVX2;
+    if (noiseBackendSupported(NOISE_SSE41)) return NOISE_SSE41;
+    return NOISE_SCALAR;
+}
+
+static NoiseBackend activeBackend = detectNoiseBackend();
+
+static const NoiseBatchKernels& activeKernels() {
+#ifdef NOISE_X86
+    if (activeBackend == NOISE_AVX2) return noiseKernelsAVX2;
+    if (activeBackend == NOISE_SSE41) return noiseKernelsSSE41;
+#endif
+    return noiseKernelsScalar;
+}
+
+NoiseBackend noiseBackend() {
+    return activeBackend;
+}
+
+void setNoiseBackend(NoiseBackend backend) {
+    if (noiseBackendSupported(backend)) {
+        activeBackend = backend;
+    }
+}
+
+void perlinNoiseBatch(const float* x, const float* y, const float* z, float* out, size_t count) {
+    activeKernels().perlin(x, y, z, out, count);
+}
+
+void simplexNoiseBatch(const float* x, const float* y, const float* z, float* out, size_t count) {
+    activeKernels().simplex(x, y, z, out, count);
+}
+
+void fbmNoiseBatch(const float* x, const float* y, const float* z, float* out, size_t count, int octaves) {
+    activeKernels().fbm(x, y, z, out, count, octaves);
+}
+
+void turbulenceNoiseBatch(const float* x, const float* y, const float* z, float* out, size_t count, int octaves) {
+    activeKernels().turbulence(x, y, z, out, count, octaves);
+}
+
+void multifractalNoiseBatch(const float* x, const float* y, const float* z, float* out, size_t count,
+                            float lacunarity, int octaves) {
+    activeKernels().multifractal(x, y, z, out, count, lacunarity, octaves);
+}
+
+void cellularNoiseBatch(const float* x, const float* y, const float* z, float* out, size_t count) {
+    activeKernels().cellular(x, y, z, out, count);
+}
+
+void valueNoiseBatch(const float* x, const float* y, float* out, size_t count) {
+    activeKernels().value(x, y, out, count);
+}
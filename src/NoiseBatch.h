@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+
+// One backend's batched noise entry points; Noise.h picks the table to call
+// through. Only the noise sources include this.
+struct NoiseBatchKernels {
+    void (*perlin)(const float* x, const float* y, const float* z, float* out, size_t count);
+    void (*simplex)(const float* x, const float* y, const float* z, float* out, size_t count);
+    void (*fbm)(const float* x, const float* y, const float* z, float* out, size_t count, int octaves);
+    void (*turbulence)(const float* x, const float* y, const float* z, float* out, size_t count, int octaves);
+    void (*multifractal)(const float* x, const float* y, const float* z, float* out, size_t count,
+                         float lacunarity, int octaves);
+    void (*cellular)(const float* x, const float* y, const float* z, float* out, size_t count);
+    void (*value)(const float* x, const float* y, float* out, size_t count);
+};
+
+#if defined(__x86_64__) || defined(__i386__)
+#define NOISE_X86 1
+extern const NoiseBatchKernels noiseKernelsSSE41;
+extern const NoiseBatchKernels noiseKernelsAVX2;
+#endif
@@ -0,0 +1,201 @@
+#include "Bake.h"
+#include "Benchmark.h"
+#include "JobSystem.h"
+#include "Noise.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+struct NoiseCase {
+    const char* name;
+    int octaves;    // 0 for single-octave noises
+};
+
+static const NoiseCase noiseCases[] = {
+    {"perlin", 0},
+    {"simplex", 0},
+    {"fbm", 1}, {"fbm", 2}, {"fbm", 4}, {"fbm", 8},
+    {"turbulence", 1}, {"turbulence", 2}, {"turbulence", 4}, {"turbulence", 8},
+    {"multifractal", 1}, {"multifractal", 2}, {"multifractal", 4}, {"multifractal", 8},
+    {"cellular", 0},
+    {"value", 0},
+};
+
+struct NoiseResult {
+    NoiseBackend backend;
+    const NoiseCase* noise;
+    double nsPerSample;
+    double maxError;    // against the scalar backend
+};
+
+static void evaluateCase(const NoiseCase& noise, const std::vector<float>& x, const std::vector<float>& y,
+                         const std::vector<float>& z, std::vector<float>& out) {
+    std::string name = noise.name;
+    size_t count = x.size();
+    if (name == "perlin") perlinNoiseBatch(x.data(), y.data(), z.data(), out.data(), count);
+    else if (name == "simplex") simplexNoiseBatch(x.data(), y.data(), z.data(), out.data(), count);
+    else if (name == "fbm") fbmNoiseBatch(x.data(), y.data(), z.data(), out.data(), count, noise.octaves);
+    else if (name == "turbulence") turbulenceNoiseBatch(x.data(), y.data(), z.data(), out.data(), count, noise.octaves);
+    else if (name == "multifractal") multifractalNoiseBatch(x.data(), y.data(), z.data(), out.data(), count, 2.0f, noise.octaves);
+    else if (name == "cellular") cellularNoiseBatch(x.data(), y.data(), z.data(), out.data(), count);
+    else if (name == "value") valueNoiseBatch(x.data(), y.data(), out.data(), count);
+}
+
+int runNoiseBenchmark(const BenchmarkOptions& options) {
+    typedef std::chrono::steady_clock Clock;
+    const size_t sampleCount = 16384;
+    const int repeats = 5;
+
+    // Fixed seed so every run measures the same points
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> coordinate(-16.0f, 16.0f);
+    std::vector<float> x(sampleCount), y(sampleCount), z(sampleCount);
+    for (size_t i = 0; i < sampleCount; i++) {
+        x[i] = coordinate(rng);
+        y[i] = coordinate(rng);
+        z[i] = coordinate(rng);
+    }
+
+    NoiseBackend defaultBackend = noiseBackend();
+    const size_t caseCount = sizeof(noiseCases) / sizeof(noiseCases[0]);
+    std::vector<std::vector<float>> reference(caseCount, std::vector<float>(sampleCount));
+    std::vector<float> out(sampleCount);
+    std::vector<NoiseResult> results;
+
+    for (int b = 0; b < NOISE_BACKEND_COUNT; b++) {
+        NoiseBackend backend = (NoiseBackend)b;
+        if (!noiseBackendSupported(backend)) continue;
+        setNoiseBackend(backend);
+
+        for (size_t c = 0; c < caseCount; c++) {
+            // Best of several passes, the first one also warms the caches
+            double best = 1e30;
+            for (int r = 0; r < repeats; r++) {
+                Clock::time_point start = Clock::now();
+                evaluateCase(noiseCases[c], x, y, z, out);
+                best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+            }
+
+            if (backend == NOISE_SCALAR) reference[c] = out;
+            double maxError = 0.0;
+            for (size_t i = 0; i < sampleCount; i++) {
+                maxError = std::max(maxError, (double)std::fabs(out[i] - reference[c][i]));
+            }
+
+            NoiseResult result = {backend, &noiseCases[c], best / sampleCount, maxError};
+            results.push_back(result);
+        }
+    }
+    setNoiseBackend(defaultBackend);
+
+    std::ofstream file(options.outputPath);
+    if (!file) {
+        std::cout << "ERROR::BENCHMARK::CANNOT_WRITE_OUTPUT: " << options.outputPath << std::endl;
+        return -1;
+    }
+
+    file << "{\n";
+    file << "  \"samples\": " << sampleCount << ",\n";
+    file << "  \"default_backend\": \"" << noiseBackendName(defaultBackend) << "\",\n";
+    file << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const NoiseResult& r = results[i];
+        file << "    {\"backend\": \"" << noiseBackendName(r.backend) << "\""
+             << ", \"noise\": \"" << r.noise->name << "\""
+             << ", \"octaves\": " << std::max(1, r.noise->octaves)
+             << ", \"ns_per_sample\": " << r.nsPerSample
+             << ", \"max_error\": " << r.maxError << "}"
+             << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n";
+    file << "}\n";
+
+    std::cout << "Noise benchmark: " << sampleCount << " samples, ns/sample (speedup over scalar)" << std::endl;
+    for (size_t c = 0; c < caseCount; c++) {
+        char label[32];
+        std::snprintf(label, sizeof(label), "%s x%d", noiseCases[c].name, std::max(1, noiseCases[c].octaves));
+        std::printf("  %-16s", label);
+        double scalar = 0.0;
+        for (const NoiseResult& r : results) {
+            if (r.noise != &noiseCases[c]) continue;
+            if (r.backend == NOISE_SCALAR) scalar = r.nsPerSample;
+            std::printf("  %s %8.1f (%4.1fx)", noiseBackendName(r.backend), r.nsPerSample, scalar / r.nsPerSample);
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
+
+int runBakeBenchmark(const BenchmarkOptions& options) {
+    typedef std::chrono::steady_clock Clock;
+    const int resolution = 128;
+    const int repeats = 3;
+
+    // Four octaves of fbm, like the room 1 cube, over a 4x4x4 box
+    NoiseField field = [](const NoiseSamples& samples, float* const* out) {
+        fbmNoiseBatch(samples.x.data(), samples.y.data(), samples.z.data(), out[0], samples.size());
+    };
+    Bounds bounds = {glm::vec3(-2.0f), glm::vec3(2.0f)};
+    double voxels = (double)resolution * resolution * resolution;
+
+    // Powers of two up to the core count, plus the core count itself. The
+    // waiting thread helps, so n threads means n - 1 workers.
+    int cores = std::max(1, (int)std::thread::hardware_concurrency());
+    std::vector<int> threadCounts;
+    for (int n = 1; n < cores; n *= 2) threadCounts.push_back(n);
+    threadCounts.push_back(cores);
+
+    std::vector<double> rates;
+    for (int threads : threadCounts) {
+        JobSystem jobs;
+        startJobSystem(jobs, threads - 1);
+
+        double best = 1e30;
+        for (int r = 0; r < repeats; r++) {
+            BakeTask task;
+            task.bounds = bounds;
+            task.size = glm::ivec3(resolution);
+            task.channels = 1;
+            task.field = field;
+
+            Clock::time_point start = Clock::now();
+            startBake(jobs, task);
+            waitForGroup(jobs, task.group);
+            best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+        }
+        stopJobSystem(jobs);
+        rates.push_back(voxels / best);
+    }
+
+    std::ofstream file(options.outputPath);
+    if (!file) {
+        std::cout << "ERROR::BENCHMARK::CANNOT_WRITE_OUTPUT: " << options.outputPath << std::endl;
+        return -1;
+    }
+
+    file << "{\n";
+    file << "  \"resolution\": " << resolution << ",\n";
+    file << "  \"noise_backend\": \"" << noiseBackendName(noiseBackend()) << "\",\n";
+    file << "  \"results\": [\n";
+    for (size_t i = 0; i < threadCounts.size(); i++) {
+        file << "    {\"threads\": " << threadCounts[i]
+             << ", \"voxels_per_second\": " << rates[i]
+             << ", \"speedup\": " << rates[i] / rates[0] << "}"
+             << (i + 1 < threadCounts.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n";
+    file << "}\n";
+
+    std::cout << "Bake benchmark: " << resolution << "^3 fbm volume, " << noiseBackendName(noiseBackend()) << std::endl;
+    for (size_t i = 0; i < threadCounts.size(); i++) {
+        std::printf("  %2d threads  %8.2f Mvoxels/s  %5.2fx  (%3.0f%% efficiency)\n", threadCounts[i], rates[i] / 1.0e6,
+                    rates[i] / rates[0], 100.0 * rates[i] / rates[0] / threadCounts[i]);
+    }
+    return 0;
+}
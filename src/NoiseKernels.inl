@@ -0,0 +1,286 @@
+// Lane-generic versions of the noise ports in Noise.cpp, shared by the SIMD
+// backends. Each backend includes this inside an anonymous namespace after
+// defining its lane type V and LANES, plus:
+//   vload, vstore, vfloor, vabs, vmin, vmax, vsqrt, vstep, vsinExact
+// The math mirrors Noise.cpp operation for operation (same association as
+// glm's dot, mix and step), so a backend only differs from the scalar code
+// where it cannot help it.
+
+inline V vfract(V x) { return x - vfloor(x); }
+inline V vmix(V x, V y, V a) { return x * (1.0f - a) + y * a; }
+inline V vdot3(V ax, V ay, V az, V bx, V by, V bz) { return ax * bx + ay * by + az * bz; }
+
+inline V mod289(V x) { return x - vfloor(x * (1.0f / 289.0f)) * 289.0f; }
+inline V permute(V x) { return mod289(((x * 34.0f) + 1.0f) * x); }
+inline V taylorInvSqrt(V r) { return 1.79284291400159f - 0.85373472095314f * r; }
+inline V fade(V t) { return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f); }
+
+// Polynomial sin for the smooth (non-hash) uses; |x| stays small there.
+// Reduces by pi to [-pi/2, pi/2], where the series up to x^11 is below
+// float precision.
+inline V vsin(V x) {
+    V k = vfloor(x * 0.318309886f + 0.5f);
+    V r = x - k * 3.14159274f;
+    r = r + k * 8.74227766e-8f;
+    V r2 = r * r;
+    V p = -2.50521084e-8f;
+    p = p * r2 + 2.75573192e-6f;
+    p = p * r2 - 1.98412698e-4f;
+    p = p * r2 + 8.33333333e-3f;
+    p = p * r2 - 1.66666667e-1f;
+    V s = r + r * r2 * p;
+    V odd = k - 2.0f * vfloor(k * 0.5f);
+    return s * (1.0f - 2.0f * odd);
+}
+
+// One gradient lattice layer of Perlin, in place on (gx, gy, gz)
+inline void perlinGradient(V ixy, V& gx, V& gy, V& gz) {
+    gx = ixy * (1.0f / 7.0f);
+    gy = vfract(vfloor(gx) * (1.0f / 7.0f)) - 0.5f;
+    gx = vfract(gx);
+    gz = V(0.5f) - vabs(gx) - vabs(gy);
+    V sz = vstep(gz, 0.0f);
+    gx = gx - sz * (vstep(0.0f, gx) - 0.5f);
+    gy = gy - sz * (vstep(0.0f, gy) - 0.5f);
+
+    V norm = taylorInvSqrt(vdot3(gx, gy, gz, gx, gy, gz));
+    gx = gx * norm;
+    gy = gy * norm;
+    gz = gz * norm;
+}
+
+inline V perlin(V px, V py, V pz) {
+    V i0x = mod289(vfloor(px)), i0y = mod289(vfloor(py)), i0z = mod289(vfloor(pz));
+    V i1x = mod289(i0x + 1.0f), i1y = mod289(i0y + 1.0f), i1z = mod289(i0z + 1.0f);
+    V f0x = vfract(px), f0y = vfract(py), f0z = vfract(pz);
+    V f1x = f0x - 1.0f, f1y = f0y - 1.0f, f1z = f0z - 1.0f;
+
+    // Corner c of each z layer sits at (c & 1, c & 2)
+    V ix[4] = {i0x, i1x, i0x, i1x};
+    V iy[4] = {i0y, i0y, i1y, i1y};
+    V fx[4] = {f0x, f1x, f0x, f1x};
+    V fy[4] = {f0y, f0y, f1y, f1y};
+
+    V n0[4], n1[4];
+    for (int c = 0; c < 4; c++) {
+        V ixy = permute(permute(ix[c]) + iy[c]);
+        V gx, gy, gz;
+        perlinGradient(permute(ixy + i0z), gx, gy, gz);
+        n0[c] = vdot3(gx, gy, gz, fx[c], fy[c], f0z);
+        perlinGradient(permute(ixy + i1z), gx, gy, gz);
+        n1[c] = vdot3(gx, gy, gz, fx[c], fy[c], f1z);
+    }
+
+    V fadeX = fade(f0x), fadeY = fade(f0y), fadeZ = fade(f0z);
+    V nz[4];
+    for (int c = 0; c < 4; c++) {
+        nz[c] = vmix(n0[c], n1[c], fadeZ);
+    }
+    V nyz0 = vmix(nz[0], nz[2], fadeY);
+    V nyz1 = vmix(nz[1], nz[3], fadeY);
+    return 2.2f * vmix(nyz0, nyz1, fadeX);
+}
+
+inline V simplex(V vx, V vy, V vz) {
+    const float Cx = 1.0f / 6.0f;
+    const float Cy = 1.0f / 3.0f;
+
+    // First corner
+    V s = vdot3(vx, vy, vz, Cy, Cy, Cy);
+    V ix = vfloor(vx + s), iy = vfloor(vy + s), iz = vfloor(vz + s);
+    V t = vdot3(ix, iy, iz, Cx, Cx, Cx);
+    V x0x = vx - ix + t, x0y = vy - iy + t, x0z = vz - iz + t;
+
+    // Other corners
+    V gx = vstep(x0y, x0x), gy = vstep(x0z, x0y), gz = vstep(x0x, x0z);
+    V lx = 1.0f - gx, ly = 1.0f - gy, lz = 1.0f - gz;
+    V i1x = vmin(gx, lz), i1y = vmin(gy, lx), i1z = vmin(gz, ly);
+    V i2x = vmax(gx, lz), i2y = vmax(gy, lx), i2z = vmax(gz, ly);
+
+    V xs[4] = {x0x, x0x - i1x + Cx, x0x - i2x + Cy, x0x - 0.5f};
+    V ys[4] = {x0y, x0y - i1y + Cx, x0y - i2y + Cy, x0y - 0.5f};
+    V zs[4] = {x0z, x0z - i1z + Cx, x0z - i2z + Cy, x0z - 0.5f};
+
+    // Permutations
+    ix = mod289(ix);
+    iy = mod289(iy);
+    iz = mod289(iz);
+    V ox[4] = {0.0f, i1x, i2x, 1.0f};
+    V oy[4] = {0.0f, i1y, i2y, 1.0f};
+    V oz[4] = {0.0f, i1z, i2z, 1.0f};
+
+    const float n_ = 0.142857142857f;
+    const float nsX = n_ * 2.0f, nsY = n_ * 0.5f - 1.0f, nsZ = n_ * 1.0f;
+
+    V terms[4];
+    for (int c = 0; c < 4; c++) {
+        V p = permute(permute(permute(iz + oz[c]) + iy + oy[c]) + ix + ox[c]);
+
+        // Gradients: 7x7 points over a square, mapped onto an octahedron
+        V j = p - 49.0f * vfloor(p * nsZ * nsZ);
+        V x_ = vfloor(j * nsZ);
+        V y_ = vfloor(j - 7.0f * x_);
+        V x = x_ * nsX + nsY;
+        V y = y_ * nsX + nsY;
+        V h = 1.0f - vabs(x) - vabs(y);
+
+        V sx = vfloor(x) * 2.0f + 1.0f;
+        V sy = vfloor(y) * 2.0f + 1.0f;
+        V sh = -vstep(h, 0.0f);
+        V ax = x + sx * sh;
+        V ay = y + sy * sh;
+
+        V norm = taylorInvSqrt(vdot3(ax, ay, h, ax, ay, h));
+        ax = ax * norm;
+        ay = ay * norm;
+        h = h * norm;
+
+        V m = vmax(0.6f - vdot3(xs[c], ys[c], zs[c], xs[c], ys[c], zs[c]), 0.0f);
+        m = m * m;
+        terms[c] = m * m * vdot3(ax, ay, h, xs[c], ys[c], zs[c]);
+    }
+    return 42.0f * ((terms[0] + terms[1]) + (terms[2] + terms[3]));
+}
+
+inline V fbm(V x, V y, V z, int octaves) {
+    float amplitude = 0.5f;
+    float frequency = 1.0f;
+    V noiseSum = 0.0f;
+    float amplitudeSum = 0.0f;
+
+    for (int i = 0; i < octaves; i++) {
+        noiseSum = noiseSum + amplitude * perlin(x * frequency, y * frequency, z * frequency);
+        amplitudeSum += amplitude;
+        amplitude *= 0.5f;
+        frequency *= 2.0f;
+    }
+
+    return noiseSum / amplitudeSum;
+}
+
+inline V turbulence(V x, V y, V z, int octaves) {
+    V sum = 0.0f;
+    float frequency = 1.0f;
+    float amplitude = 1.0f;
+    float maxValue = 0.0f;
+
+    for (int i = 0; i < octaves; i++) {
+        sum = sum + vabs(perlin(x * frequency, y * frequency, z * frequency)) * amplitude;
+        maxValue += amplitude;
+        amplitude *= 0.5f;
+        frequency *= 2.0f;
+    }
+
+    return sum / maxValue;
+}
+
+inline V multifractal(V x, V y, V z, float lacunarity, int octaves) {
+    V value = 1.0f;
+    float frequency = 1.0f;
+    V weight = 1.0f;
+
+    for (int i = 0; i < octaves; i++) {
+        value = value * (weight * simplex(x * frequency, y * frequency, z * frequency) + 1.0f);
+        frequency *= lacunarity;
+        weight = vmin(vmax(value, 0.0f), 1.0f);
+    }
+
+    return value;
+}
+
+// The hash amplifies every bit of sin's argument, so it goes through the
+// same libm sin as the scalar code rather than the polynomial
+inline V hashComponent(V px, V py, V pz, float a, float b, float c) {
+    return -1.0f + 2.0f * vfract(vsinExact(vdot3(px, py, pz, a, b, c)) * 43758.5453123f);
+}
+
+inline V cellular(V px, V py, V pz) {
+    V ipx = vfloor(px), ipy = vfloor(py), ipz = vfloor(pz);
+    V fpx = vfract(px), fpy = vfract(py), fpz = vfract(pz);
+    V minDist = 1.0f;
+
+    for (int k = -1; k <= 1; k++)
+    for (int j = -1; j <= 1; j++)
+    for (int i = -1; i <= 1; i++) {
+        V nx = (float)i, ny = (float)j, nz = (float)k;
+        V cx = ipx + nx, cy = ipy + ny, cz = ipz + nz;
+        V pointX = hashComponent(cx, cy, cz, 127.1f, 311.7f, 74.7f);
+        V pointY = hashComponent(cx, cy, cz, 269.5f, 183.3f, 246.1f);
+        V pointZ = hashComponent(cx, cy, cz, 113.5f, 271.9f, 124.6f);
+        pointX = 0.5f + 0.5f * vsin(pointX * 6.2831853f);
+        pointY = 0.5f + 0.5f * vsin(pointY * 6.2831853f);
+        pointZ = 0.5f + 0.5f * vsin(pointZ * 6.2831853f);
+        V dx = nx + pointX - fpx, dy = ny + pointY - fpy, dz = nz + pointZ - fpz;
+        minDist = vmin(minDist, vsqrt(vdot3(dx, dy, dz, dx, dy, dz)));
+    }
+    return minDist;
+}
+
+inline V hash2(V x, V y) {
+    return vfract(vsinExact(x * 12.9898f + y * 78.233f) * 43758.5453f);
+}
+
+inline V value(V px, V py) {
+    V ix = vfloor(px), iy = vfloor(py);
+    V ux = vfract(px), uy = vfract(py);
+    ux = ux * ux * (3.0f - 2.0f * ux);
+    uy = uy * uy * (3.0f - 2.0f * uy);
+
+    V res = vmix(vmix(hash2(ix, iy), hash2(ix + 1.0f, iy), ux),
+                 vmix(hash2(ix, iy + 1.0f), hash2(ix + 1.0f, iy + 1.0f), ux), uy);
+    return res * res;
+}
+
+// Full vectors straight from the arrays, then the tail through a padded copy
+template<typename Kernel>
+void runBatch(const float* x, const float* y, const float* z, float* out, size_t count, Kernel kernel) {
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        vstore(out + i, kernel(vload(x + i), vload(y + i), vload(z + i)));
+    }
+    if (i < count) {
+        float tail[4][LANES] = {};
+        size_t rest = count - i;
+        for (size_t l = 0; l < rest; l++) {
+            tail[0][l] = x[i + l];
+            tail[1][l] = y[i + l];
+            tail[2][l] = z[i + l];
+        }
+        vstore(tail[3], kernel(vload(tail[0]), vload(tail[1]), vload(tail[2])));
+        for (size_t l = 0; l < rest; l++) {
+            out[i + l] = tail[3][l];
+        }
+    }
+}
+
+void perlinBatch(const float* x, const float* y, const float* z, float* out, size_t count) {
+    runBatch(x, y, z, out, count, [](V px, V py, V pz) { return perlin(px, py, pz); });
+}
+
+void simplexBatch(const float* x, const float* y, const float* z, float* out, size_t count) {
+    runBatch(x, y, z, out, count, [](V px, V py, V pz) { return simplex(px, py, pz); });
+}
+
+void fbmBatch(const float* x, const float* y, const float* z, float* out, size_t count, int octaves) {
+    runBatch(x, y, z, out, count, [octaves](V px, V py, V pz) { return fbm(px, py, pz, octaves); });
+}
+
+void turbulenceBatch(const float* x, const float* y, const float* z, float* out, size_t count, int octaves) {
+    runBatch(x, y, z, out, count, [octaves](V px, V py, V pz) { return turbulence(px, py, pz, octaves); });
+}
+
+void multifractalBatch(const float* x, const float* y, const float* z, float* out, size_t count,
+                       float lacunarity, int octaves) {
+    runBatch(x, y, z, out, count, [lacunarity, octaves](V px, V py, V pz) {
+        return multifractal(px, py, pz, lacunarity, octaves);
+    });
+}
+
+void cellularBatch(const float* x, const float* y, const float* z, float* out, size_t count) {
+    runBatch(x, y, z, out, count, [](V px, V py, V pz) { return cellular(px, py, pz); });
+}
+
+void valueBatch(const float* x, const float* y, float* out, size_t count) {
+    // No z array: the main loop reads y again in its place and ignores it
+    runBatch(x, y, y, out, count, [](V px, V py, V) { return value(px, py); });
+}
@@ -0,0 +1,52 @@
+#include "NoiseBatch.h"
+
+#ifdef NOISE_X86
+#include <immintrin.h>
+#include <cmath>
+
+// Compiled for SSE4.1 regardless of the command line flags; only called
+// after the CPU check in NoiseBatch.cpp
+#pragma GCC target("sse4.1")
+
+namespace {
+
+struct V {
+    __m128 v;
+    V() {}
+    V(__m128 v) : v(v) {}
+    V(float f) : v(_mm_set1_ps(f)) {}
+};
+
+const int LANES = 4;
+
+inline V operator+(V a, V b) { return _mm_add_ps(a.v, b.v); }
+inline V operator-(V a, V b) { return _mm_sub_ps(a.v, b.v); }
+inline V operator*(V a, V b) { return _mm_mul_ps(a.v, b.v); }
+inline V operator/(V a, V b) { return _mm_div_ps(a.v, b.v); }
+inline V operator-(V a) { return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)); }
+
+inline V vload(const float* p) { return _mm_loadu_ps(p); }
+inline void vstore(float* p, V a) { _mm_storeu_ps(p, a.v); }
+inline V vfloor(V a) { return _mm_floor_ps(a.v); }
+inline V vabs(V a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+inline V vmin(V a, V b) { return _mm_min_ps(a.v, b.v); }
+inline V vmax(V a, V b) { return _mm_max_ps(a.v, b.v); }
+inline V vsqrt(V a) { return _mm_sqrt_ps(a.v); }
+// GLSL step: x < edge ? 0 : 1
+inline V vstep(V edge, V x) { return _mm_and_ps(_mm_cmpnlt_ps(x.v, edge.v), _mm_set1_ps(1.0f)); }
+
+inline V vsinExact(V a) {
+    alignas(16) float lanes[LANES];
+    _mm_store_ps(lanes, a.v);
+    for (int i = 0; i < LANES; i++) lanes[i] = std::sin(lanes[i]);
+    return _mm_load_ps(lanes);
+}
+
+#include "NoiseKernels.inl"
+
+}
+
+const NoiseBatchKernels noiseKernelsSSE41 = {
+    perlinBatch, simplexBatch, fbmBatch, turbulenceBatch, multifractalBatch, cellularBatch, valueBatch
+};
+#endif
@@ -0,0 +1,128 @@
+#include "Portals.h"
+#include "FrameStats.h"
+#include <algorithm>
+
+// Screen-space rectangle in normalized device coordinates
+struct ScreenRect {
+    glm::vec2 min;
+    glm::vec2 max;
+};
+
+int addCell(PortalGraph& graph, const glm::vec3& min, const glm::vec3& max) {
+    Cell cell;
+    cell.min = min;
+    cell.max = max;
+    graph.cells.push_back(cell);
+    return (int)graph.cells.size() - 1;
+}
+
+void addPortal(PortalGraph& graph, int cellA, int cellB, const glm::vec3 corners[4]) {
+    Portal portal;
+    portal.cells[0] = cellA;
+    portal.cells[1] = cellB;
+    for (int i = 0; i < 4; i++) {
+        portal.corners[i] = corners[i];
+    }
+    graph.portals.push_back(portal);
+}
+
+int findCell(const PortalGraph& graph, const glm::vec3& position) {
+    for (size_t i = 0; i < graph.cells.size(); i++) {
+        const Cell& cell = graph.cells[i];
+        if (glm::all(glm::greaterThanEqual(position, cell.min)) && glm::all(glm::lessThanEqual(position, cell.max))) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+// Projects the portal and clips it against the rectangle it is seen through.
+// Returns false when nothing of the portal is visible.
+static bool clipPortal(const Portal& portal, const glm::mat4& viewProjection, float nearPlane,
+                       const ScreenRect& bounds, ScreenRect& clipped) {
+    ScreenRect projected;
+    projected.min = glm::vec2(1e30f);
+    projected.max = glm::vec2(-1e30f);
+    int behind = 0;
+    bool crossesNear = false;
+
+    for (const glm::vec3& corner : portal.corners) {
+        glm::vec4 clip = viewProjection * glm::vec4(corner, 1.0f);
+        if (clip.w <= 0.0f) {
+            behind++;
+        }
+        if (clip.w < nearPlane) {
+            crossesNear = true;
+            continue;
+        }
+        glm::vec2 ndc = glm::vec2(clip) / clip.w;
+        projected.min = glm::min(projected.min, ndc);
+        projected.max = glm::max(projected.max, ndc);
+    }
+
+    if (behind == 4) return false;
+
+    // Corners in front of the near plane can't be projected reliably; with the
+    // camera that close to the doorway just keep the incoming rectangle
+    if (crossesNear) {
+        clipped = bounds;
+        return true;
+    }
+
+    clipped.min = glm::max(projected.min, bounds.min);
+    clipped.max = glm::min(projected.max, bounds.max);
+    return clipped.min.x < clipped.max.x && clipped.min.y < clipped.max.y;
+}
+
+static void traverse(const PortalGraph& graph, int cell, const ScreenRect& bounds, const glm::mat4& viewProjection,
+                     float nearPlane, std::vector<int>& path, Visibility& visibility) {
+    visibility.cellVisible[cell] = true;
+    path.push_back(cell);
+
+    for (const Portal& portal : graph.portals) {
+        int next;
+        if (portal.cells[0] == cell) {
+            next = portal.cells[1];
+        } else if (portal.cells[1] == cell) {
+            next = portal.cells[0];
+        } else {
+            continue;
+        }
+        // Don't walk back through the cells already on this path
+        if (std::find(path.begin(), path.end(), next) != path.end()) continue;
+
+        frameStats.portalsTested++;
+        ScreenRect clipped;
+        if (clipPortal(portal, viewProjection, nearPlane, bounds, clipped)) {
+            traverse(graph, next, clipped, viewProjection, nearPlane, path, visibility);
+        }
+    }
+
+    path.pop_back();
+}
+
+void computeVisibility(const PortalGraph& graph, const glm::vec3& position, const glm::mat4& viewProjection,
+                       float nearPlane, Visibility& visibility) {
+    visibility.cameraCell = findCell(graph, position);
+    if (visibility.cameraCell < 0) {
+        markAllVisible(graph, visibility);
+        return;
+    }
+
+    visibility.cellVisible.assign(graph.cells.size(), false);
+
+    ScreenRect screen;
+    screen.min = glm::vec2(-1.0f);
+    screen.max = glm::vec2(1.0f);
+    std::vector<int> path;
+    traverse(graph, visibility.cameraCell, screen, viewProjection, nearPlane, path, visibility);
+
+    for (bool visible : visibility.cellVisible) {
+        if (visible) frameStats.visibleCells++;
+    }
+}
+
+void markAllVisible(const PortalGraph& graph, Visibility& visibility) {
+    visibility.cellVisible.assign(graph.cells.size(), true);
+    frameStats.visibleCells += (unsigned int)graph.cells.size();
+}
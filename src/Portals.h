@@ -0,0 +1,42 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+// Cell/portal visibility. The level is split into convex cells (rooms and
+// corridors) joined by portals (door openings). Each frame the graph is walked
+// from the camera's cell; every portal crossed narrows a screen-space
+// rectangle, and only cells reached with a non-empty rectangle are drawn, so
+// the cost follows what is visible rather than the size of the level.
+struct Cell {
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+// Planar quad joining two cells, corners in winding order
+struct Portal {
+    int cells[2];
+    glm::vec3 corners[4];
+};
+
+struct PortalGraph {
+    std::vector<Cell> cells;
+    std::vector<Portal> portals;
+};
+
+struct Visibility {
+    int cameraCell = -1;                // -1 when the camera is outside every cell
+    std::vector<bool> cellVisible;
+};
+
+int addCell(PortalGraph& graph, const glm::vec3& min, const glm::vec3& max);
+void addPortal(PortalGraph& graph, int cellA, int cellB, const glm::vec3 corners[4]);
+
+int findCell(const PortalGraph& graph, const glm::vec3& position);
+
+// Fills visibility for a camera at position. With the camera outside every
+// cell (free flight through a wall) all cells are marked visible.
+void computeVisibility(const PortalGraph& graph, const glm::vec3& position, const glm::mat4& viewProjection,
+                       float nearPlane, Visibility& visibility);
+
+void markAllVisible(const PortalGraph& graph, Visibility& visibility);
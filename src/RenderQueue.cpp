@@ -0,0 +1,240 @@
+#include "RenderQueue.h"
+#include "FrameStats.h"
+#include "Instancing.h"
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+
+static const uint64_t DEPTH_BITS = 24;
+static const uint64_t DEPTH_MAX = (1ull << DEPTH_BITS) - 1;
+
+uint64_t makeSortKey(RenderPass pass, unsigned int program, unsigned int vao, float depth, float farPlane) {
+    uint64_t quantized = (uint64_t)(glm::clamp(depth / farPlane, 0.0f, 1.0f) * DEPTH_MAX);
+    uint64_t programBits = program & 0xFFFF;
+    uint64_t vaoBits = vao & 0xFFFF;
+
+    uint64_t key = (uint64_t)pass << 62;
+    if (pass == PASS_TRANSPARENT) {
+        key |= (DEPTH_MAX - quantized) << 38;
+        key |= programBits << 22;
+        key |= vaoBits << 6;
+    } else {
+        key |= programBits << 46;
+        key |= vaoBits << 30;
+        key |= quantized << 6;
+    }
+    return key;
+}
+
+void beginRenderQueue(RenderQueue& queue, const glm::mat4& view, float farPlane, GLenum indexType) {
+    queue.view = view;
+    queue.farPlane = farPlane;
+    queue.indexType = indexType;
+    queue.commands.clear();
+}
+
+void submitDraw(RenderQueue& queue, RenderPass pass, const ShaderProgram& program, unsigned int vao,
+                const MeshRange& mesh, const Transform& transform, const glm::vec3& center,
+                unsigned int materialBuffer, GLintptr materialOffset) {
+    // View space looks down -z
+    float depth = -(queue.view * glm::vec4(center, 1.0f)).z;
+
+    DrawCommand command;
+    command.key = makeSortKey(pass, program.id, vao, depth, queue.farPlane);
+    command.program = &program;
+    command.vao = vao;
+    command.baseVertex = mesh.baseVertex;
+    command.count = mesh.count;
+    command.firstIndex = mesh.firstIndex;
+    command.instanceCount = 0;
+    command.transform = &transform;
+    command.materialBuffer = materialBuffer;
+    command.materialOffset = materialOffset;
+    queue.commands.push_back(command);
+}
+
+void submitInstancedDraw(RenderQueue& queue, RenderPass pass, const ShaderProgram& program, unsigned int vao,
+                         const MeshRange& mesh, GLsizei instanceCount, const glm::vec3& center) {
+    submitDraw(queue, pass, program, vao, mesh, IDENTITY_TRANSFORM, center);
+    queue.commands.back().instanceCount = instanceCount;
+}
+
+// LSD radix sort, one byte per pass; passes where every key has the same
+// byte are skipped, which is most of them for a handful of programs.
+static void radixSort(std::vector<RenderQueue::SortItem>& items, std::vector<RenderQueue::SortItem>& scratch) {
+    if (items.size() < 2) return;
+    scratch.resize(items.size());
+
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t counts[256] = {};
+        for (const RenderQueue::SortItem& item : items) {
+            counts[(item.key >> shift) & 0xFF]++;
+        }
+        if (counts[(items[0].key >> shift) & 0xFF] == items.size()) continue;
+
+        size_t offset = 0;
+        for (int digit = 0; digit < 256; digit++) {
+            size_t count = counts[digit];
+            counts[digit] = offset;
+            offset += count;
+        }
+        for (const RenderQueue::SortItem& item : items) {
+            scratch[counts[(item.key >> shift) & 0xFF]++] = item;
+        }
+        items.swap(scratch);
+    }
+}
+
+void sortRenderQueue(RenderQueue& queue) {
+    // State changes the submission order would have cost, for comparison
+    unsigned int currentProgram = 0, currentVAO = 0;
+    for (const DrawCommand& command : queue.commands) {
+        if (command.program->id != currentProgram) {
+            currentProgram = command.program->id;
+            frameStats.programChangesUnsorted++;
+        }
+        if (command.vao != currentVAO) {
+            currentVAO = command.vao;
+            frameStats.vaoChangesUnsorted++;
+        }
+    }
+
+    queue.order.resize(queue.commands.size());
+    for (size_t i = 0; i < queue.commands.size(); i++) {
+        queue.order[i].key = queue.commands[i].key;
+        queue.order[i].index = (uint32_t)i;
+    }
+    radixSort(queue.order, queue.scratch);
+}
+
+// Index type, bound program, VAO, last transform sent and material range
+// bound, to skip redundant calls, and the draws collected since, which all
+// use that state
+struct DrawState {
+    GLenum indexType;
+    size_t indexSize;
+    unsigned int program = 0;
+    unsigned int vao = 0;
+    const Transform* transform = NULL;
+    int materialBinding = -1;
+    unsigned int materialBuffer = 0;
+    GLintptr materialOffset = 0;
+
+    std::vector<GLsizei> counts;
+    std::vector<const void*> offsets;
+    std::vector<GLint> baseVertices;
+
+    explicit DrawState(GLenum type) : indexType(type), indexSize(indexTypeSize(type)) {}
+};
+
+static void flushDraws(DrawState& state) {
+    if (state.counts.empty()) return;
+    if (state.counts.size() == 1) {
+        glDrawElementsBaseVertex(GL_TRIANGLES, state.counts[0], state.indexType, state.offsets[0],
+                                 state.baseVertices[0]);
+    } else {
+        glMultiDrawElementsBaseVertex(GL_TRIANGLES, state.counts.data(), state.indexType, state.offsets.data(),
+                                      (GLsizei)state.counts.size(), state.baseVertices.data());
+    }
+    frameStats.drawBatches++;
+    state.counts.clear();
+    state.offsets.clear();
+    state.baseVertices.clear();
+}
+
+static void issueDraw(DrawState& state, const ShaderProgram& program, const DrawCommand& command) {
+    if (program.id != state.program) {
+        flushDraws(state);
+        state.program = program.id;
+        glUseProgram(state.program);
+        frameStats.programChanges++;
+        state.transform = NULL;
+    }
+    if (command.vao != state.vao) {
+        flushDraws(state);
+        state.vao = command.vao;
+        glBindVertexArray(state.vao);
+        frameStats.vaoChanges++;
+    }
+    if (command.materialBuffer != 0 && program.materialBinding >= 0
+        && (program.materialBinding != state.materialBinding || command.materialBuffer != state.materialBuffer
+            || command.materialOffset != state.materialOffset)) {
+        flushDraws(state);
+        glBindBufferRange(GL_UNIFORM_BUFFER, program.materialBinding, command.materialBuffer,
+                          command.materialOffset, sizeof(MaterialBlock));
+        state.materialBinding = program.materialBinding;
+        state.materialBuffer = command.materialBuffer;
+        state.materialOffset = command.materialOffset;
+    }
+    if (command.instanceCount > 0) {
+        flushDraws(state);
+        glDrawElementsInstancedBaseVertex(GL_TRIANGLES, command.count, state.indexType,
+                                          (void*)(command.firstIndex * state.indexSize), command.instanceCount,
+                                          command.baseVertex);
+        frameStats.drawBatches++;
+        frameStats.instancesDrawn += command.instanceCount;
+        return;
+    }
+    // Room faces all share the identity model, skip re-sending it
+    if (state.transform == NULL || state.transform->model != command.transform->model) {
+        flushDraws(state);
+        glUniformMatrix4fv(program.uniforms[UNIFORM_MODEL], 1, GL_FALSE, glm::value_ptr(command.transform->model));
+        glUniformMatrix3fv(program.uniforms[UNIFORM_NORMAL_MATRIX], 1, GL_FALSE,
+                           glm::value_ptr(command.transform->normalMatrix));
+        state.transform = command.transform;
+    }
+
+    state.counts.push_back(command.count);
+    state.offsets.push_back((const void*)(command.firstIndex * state.indexSize));
+    state.baseVertices.push_back(command.baseVertex);
+}
+
+static bool isOpaque(const DrawCommand& command) {
+    return (command.key >> 62) == PASS_OPAQUE;
+}
+
+void executeDepthPrepass(const RenderQueue& queue, const ShaderProgram& depthProgram,
+                         const ShaderProgram& instancedDepthProgram) {
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+
+    DrawState state(queue.indexType);
+    for (const RenderQueue::SortItem& item : queue.order) {
+        const DrawCommand& command = queue.commands[item.index];
+        // Opaque draws sort first, the rest is the transparent pass
+        if (!isOpaque(command)) break;
+        issueDraw(state, command.instanceCount > 0 ? instancedDepthProgram : depthProgram, command);
+        frameStats.depthPrepassDraws++;
+    }
+    flushDraws(state);
+
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+}
+
+void executeRenderQueue(const RenderQueue& queue, bool depthPrepass) {
+    if (depthPrepass) {
+        glDepthFunc(GL_EQUAL);
+        glDepthMask(GL_FALSE);
+    }
+
+    DrawState state(queue.indexType);
+    bool transparent = false;
+    for (const RenderQueue::SortItem& item : queue.order) {
+        const DrawCommand& command = queue.commands[item.index];
+
+        if (depthPrepass && !transparent && !isOpaque(command)) {
+            flushDraws(state);
+            transparent = true;
+            glDepthFunc(GL_LESS);
+            glDepthMask(GL_TRUE);
+        }
+
+        issueDraw(state, *command.program, command);
+        frameStats.drawCalls++;
+        frameStats.trianglesDrawn += command.count / 3 * std::max<GLsizei>(command.instanceCount, 1);
+    }
+    flushDraws(state);
+
+    if (depthPrepass && !transparent) {
+        glDepthFunc(GL_LESS);
+        glDepthMask(GL_TRUE);
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "GeometryArena.h"
+#include "Shader.h"
+#include "Transforms.h"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+// Draws are recorded during the frame, sorted by a packed 64-bit key and then
+// executed in key order, so consecutive draws share program and VAO as often
+// as possible. Key layout, most significant bits first:
+//   opaque:      [63:62 pass][61:46 program][45:30 VAO][29:6 depth, front to back]
+//   transparent: [63:62 pass][61:38 depth, back to front][37:22 program][21:6 VAO]
+// The radix sort is stable, so draws with equal keys keep submission order.
+// Runs of sorted draws that share program, VAO and model matrix go to the
+// driver as one glMultiDrawElementsBaseVertex. Instanced draws take their
+// transforms from the VAO's instance attributes instead of the model and
+// normal matrix uniforms. A draw can also name the range of a uniform buffer
+// its program's Material block reads; it is bound before the draw.
+enum RenderPass {
+    PASS_OPAQUE = 0,
+    PASS_TRANSPARENT = 1
+};
+
+struct DrawCommand {
+    uint64_t key;
+    const ShaderProgram* program;
+    unsigned int vao;
+    GLint baseVertex;
+    GLsizei count;
+    unsigned int firstIndex;
+    GLsizei instanceCount;      // 0 for a plain draw
+    const Transform* transform;
+    unsigned int materialBuffer;    // 0 leaves the Material binding as it is
+    GLintptr materialOffset;
+};
+
+struct RenderQueue {
+    glm::mat4 view;
+    float farPlane;
+    GLenum indexType;           // Of every draw's index buffer
+    std::vector<DrawCommand> commands;
+
+    struct SortItem {
+        uint64_t key;
+        uint32_t index;
+    };
+    std::vector<SortItem> order;
+    std::vector<SortItem> scratch;
+};
+
+uint64_t makeSortKey(RenderPass pass, unsigned int program, unsigned int vao, float depth, float farPlane);
+
+// All draws of a frame index one geometry arena, with its indexType
+void beginRenderQueue(RenderQueue& queue, const glm::mat4& view, float farPlane, GLenum indexType);
+
+// center is the world-space point the draw is depth sorted by. The queue
+// keeps a pointer to transform, which has to stay put until it is executed.
+// A materialBuffer holds a MaterialBlock at materialOffset for the program's
+// Material block. Once any draw of a program's binding names a range, the
+// others need to as well, or they read whatever was bound last.
+void submitDraw(RenderQueue& queue, RenderPass pass, const ShaderProgram& program, unsigned int vao,
+                const MeshRange& mesh, const Transform& transform, const glm::vec3& center,
+                unsigned int materialBuffer = 0, GLintptr materialOffset = 0);
+
+// vao has to carry the instance attributes; program is an INSTANCED build
+void submitInstancedDraw(RenderQueue& queue, RenderPass pass, const ShaderProgram& program, unsigned int vao,
+                         const MeshRange& mesh, GLsizei instanceCount, const glm::vec3& center);
+
+void sortRenderQueue(RenderQueue& queue);
+
+// Writes depth for the opaque draws with a trivial program and colour writes
+// off, so the shading pass can test GL_EQUAL and shade each pixel once.
+// Instanced draws use the INSTANCED build of the depth program.
+void executeDepthPrepass(const RenderQueue& queue, const ShaderProgram& depthProgram,
+                         const ShaderProgram& instancedDepthProgram);
+
+// After a depth pre-pass the opaque draws test GL_EQUAL without writing
+// depth; transparent draws always use the default GL_LESS
+void executeRenderQueue(const RenderQueue& queue, bool depthPrepass = false);
@@ -1,16 +1,37 @@
+#ifndef ROOMS_HEADLESS
 #include <../imgui/imgui.h>
 #include <../imgui/imgui_impl_glfw.h>
 #include <../imgui/imgui_impl_opengl3.h>
+#endif
 #include <glad/glad.h>
+#ifndef ROOMS_HEADLESS
 #include <GLFW/glfw3.h>
+#endif
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <vector>
 #include <string>
-#include <fstream>
-#include <sstream>
+#include "Bake.h"
+#include "Benchmark.h"
+#include "FrameStats.h"
+#include "Frustum.h"
+#include "GeometryArena.h"
+#include "GLExtensions.h"
+#include "Instancing.h"
+#include "Lod.h"
+#include "Noise.h"
+#include "Portals.h"
+#include "RenderQueue.h"
+#include "Shader.h"
+#include "Transforms.h"
+#include "VolumeCache.h"
 
 glm::vec3 cameraPos = glm::vec3(0.0f, 0.0f, 0.0f);
 glm::vec3 cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
@@ -29,9 +50,11 @@ const float movementSpeed = 2.5f;
 bool mouseCaptured = true;
 bool firstPress = true;
 
-unsigned int cubeShader1, cubeShader2, cubeShader3;
-unsigned int sphereShader1, sphereShader2, sphereShader3;
-unsigned int pyramidShader1, pyramidShader2;
+ShaderProgram cubeShader1, cubeShader2, cubeShader3;
+ShaderProgram sphereShader1, sphereShader2, sphereShader3;
+ShaderProgram pyramidShader1, pyramidShader2;
+
+FrameStats frameStats;
 
 struct Room1NoiseParams {
     // Cube 1 parameters
@@ -90,25 +113,275 @@ struct Room3NoiseParams {
     float sphere3Glossiness = 64.0f;
 } room3Params;
 
-std::string readShaderFile(const char* filePath) {
-    std::string shaderCode;
-    std::ifstream shaderFile;
-    
-    shaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    try {
-        shaderFile.open(filePath);
-        std::stringstream shaderStream;
-        shaderStream << shaderFile.rdbuf();
-        shaderFile.close();
-        shaderCode = shaderStream.str();
-    }
-    catch (std::ifstream::failure& e) {
-        std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << filePath << std::endl;
+// Object materials, one uniform buffer each, re-uploaded only when a widget in
+// renderNoiseControls reports an edit. The structs mirror the std140 Material
+// blocks of the fragment shaders: a vec3 followed by a float shares a 16-byte
+// slot, so members are ordered to pack without padding.
+enum MaterialId {
+    MATERIAL_CUBE1,
+    MATERIAL_CUBE2,
+    MATERIAL_CUBE3,
+    MATERIAL_SPHERE1,
+    MATERIAL_SPHERE2,
+    MATERIAL_SPHERE3,
+    MATERIAL_PYRAMID1,
+    MATERIAL_PYRAMID2,
+    MATERIAL_COUNT
+};
+
+struct Cube1Material {
+    glm::vec3 baseColor;
+    float noiseScale;
+    float noiseAmplitude;
+};
+
+struct Cube2Material {
+    glm::vec3 baseColor;
+    float noiseScale;
+    float noiseIntensity;
+};
+
+struct Cube3Material {
+    glm::vec3 baseColor;
+    float noiseScale;
+    float noiseIntensity;
+    float minAlpha;
+    float maxAlpha;
+};
+
+struct Sphere1Material {
+    glm::vec3 baseColor;
+    float noiseScale;
+    float noiseOffset;
+    float noiseIntensity;
+};
+
+struct Sphere2Material {
+    glm::vec3 baseColor;
+    float noiseScale;
+    float noiseIntensity;
+    float lacunarity;
+    int octaves;
+};
+
+struct Sphere3Material {
+    glm::vec3 baseColor;
+    float noiseScale;
+    float normalStrength;
+    float glossiness;
+};
+
+struct Pyramid1Material {
+    glm::vec3 baseColor1;
+    float noiseTurbulence;
+    glm::vec3 baseColor2;
+    float noiseGlow;
+    float colorMix;
+};
+
+struct Pyramid2Material {
+    glm::vec3 baseColor1;
+    float noiseScale;
+    glm::vec3 baseColor2;
+    float noiseIntensity;
+    float edgeThreshold;
+    float glowStrength;
+};
+
+static_assert(sizeof(Pyramid1Material) == 36, "Pyramid1Material must match the std140 Material block");
+static_assert(sizeof(Pyramid2Material) == 40, "Pyramid2Material must match the std140 Material block");
+
+unsigned int materialUBOs[MATERIAL_COUNT];
+bool materialDirty[MATERIAL_COUNT];
+
+// Rooms and corridors, the cells of the portal graph
+enum LevelCell {
+    CELL_ROOM1,
+    CELL_CORRIDOR1,
+    CELL_ROOM2,
+    CELL_CORRIDOR2,
+    CELL_ROOM3,
+    CELL_COUNT
+};
+
+ShaderProgram depthShader;
+bool depthPrepass = false;
+
+PortalGraph levelPortals;
+Visibility visibility;
+bool portalCulling = true;
+
+// All static geometry: rooms, corridors, door frames and the object meshes
+GeometryArena sceneGeometry;
+
+// A range of the scene geometry lying in one cell, drawn as one command
+struct CellRange {
+    MeshRange mesh;
+    int cell;
+};
+
+CellRange corridorRanges[2];
+CellRange doorFrameRanges[4];
+
+Frustum viewFrustum;
+bool frustumCulling = true;
+
+// This frame's projection, and the window height it maps to, for LOD selection
+glm::mat4 cameraProjection;
+const float VIEWPORT_HEIGHT = 720.0f;
+
+// Object meshes; bounds are in model space and get transformed by each
+// instance's model matrix
+enum MeshId {
+    MESH_CUBE,
+    MESH_SPHERE,
+    MESH_PYRAMID,
+    MESH_COUNT
+};
+
+// Id of each object mesh in sceneGeometry
+int objectMeshes[MESH_COUNT];
+
+const MeshRange& objectMesh(MeshId id) {
+    return sceneGeometry.meshes[objectMeshes[id]];
+}
+
+// The sphere comes in levels of detail, coarsest first, picked per object
+// every frame by projected radius. The level a sphere uses moves up once it
+// would stray LOD_MAX_ERROR pixels from the silhouette and back down only
+// LOD_HYSTERESIS below that. Without LODs, and as objectMeshes[MESH_SPHERE],
+// the 32-segment level is used.
+const unsigned int SPHERE_LOD_SEGMENTS[] = {8, 16, 32, 64};
+const int SPHERE_LOD_COUNT = sizeof(SPHERE_LOD_SEGMENTS) / sizeof(SPHERE_LOD_SEGMENTS[0]);
+static_assert(SPHERE_LOD_COUNT == SPHERE_LOD_LEVELS, "FrameStats counts spheres per level");
+const int SPHERE_DEFAULT_LOD = 2;
+const float LOD_MAX_ERROR = 1.0f;
+const float LOD_HYSTERESIS = 0.2f;
+
+int sphereLods[SPHERE_LOD_COUNT];           // Ids in sceneGeometry
+float sphereLodMinRadius[SPHERE_LOD_COUNT];
+bool sphereLod = true;
+
+const MeshRange& objectMeshLod(MeshId id, int lod) {
+    return id == MESH_SPHERE ? sceneGeometry.meshes[sphereLods[lod]] : objectMesh(id);
+}
+
+// Moves lod, a sphere's level, to what its projected size calls for this
+// frame, and counts count spheres drawn at it. center is the nearest point
+// to the camera a sphere of the given radius can have.
+int updateSphereLod(int& lod, const glm::vec3& center, float radius, unsigned int count) {
+    if (sphereLod) {
+        float pixels = projectedRadius(center, radius, cameraPos, cameraProjection, VIEWPORT_HEIGHT);
+        lod = selectLod(lod, pixels, sphereLodMinRadius, SPHERE_LOD_COUNT, LOD_HYSTERESIS);
     }
-    
-    return shaderCode;
+    int level = sphereLod ? lod : SPHERE_DEFAULT_LOD;
+    frameStats.sphereLodObjects[level] += count;
+    return level;
 }
 
+// Every object in the level uses its own material
+struct SceneObject {
+    MeshId mesh;
+    MaterialId material;
+    int cell;
+    RenderPass pass;
+    glm::vec3 position;
+    glm::vec3 scale;
+};
+
+const SceneObject sceneObjects[] = {
+    // Room 1 objects
+    {MESH_CUBE, MATERIAL_CUBE1, CELL_ROOM1, PASS_OPAQUE, glm::vec3(-3.0f, -3.0f, 3.0f), glm::vec3(1.0f)},
+    {MESH_SPHERE, MATERIAL_SPHERE1, CELL_ROOM1, PASS_OPAQUE, glm::vec3(0.0f, -3.0f, 0.0f), glm::vec3(1.0f)},
+    {MESH_PYRAMID, MATERIAL_PYRAMID1, CELL_ROOM1, PASS_OPAQUE, glm::vec3(-3.0f, -3.0f, -3.0f), glm::vec3(1.0f)},
+
+    // Room 2 objects
+    {MESH_CUBE, MATERIAL_CUBE2, CELL_ROOM2, PASS_OPAQUE, glm::vec3(12.0f, -3.0f, 3.0f), glm::vec3(1.0f)},
+    {MESH_SPHERE, MATERIAL_SPHERE2, CELL_ROOM2, PASS_OPAQUE, glm::vec3(15.0f, -3.0f, 0.0f), glm::vec3(1.0f)},
+    {MESH_PYRAMID, MATERIAL_PYRAMID2, CELL_ROOM2, PASS_OPAQUE, glm::vec3(18.0f, -3.0f, -3.0f), glm::vec3(1.0f)},
+
+    // Room 3 objects; the cube puts its noise in the alpha channel and has to be blended
+    {MESH_CUBE, MATERIAL_CUBE3, CELL_ROOM3, PASS_TRANSPARENT, glm::vec3(32.0f, -3.0f, 2.5f), glm::vec3(2.5f)},
+    {MESH_SPHERE, MATERIAL_SPHERE3, CELL_ROOM3, PASS_OPAQUE, glm::vec3(32.0f, -3.0f, -2.5f), glm::vec3(1.75f)}
+};
+
+const size_t OBJECT_COUNT = sizeof(sceneObjects) / sizeof(sceneObjects[0]);
+Transform objectTransforms[OBJECT_COUNT];
+int objectLods[OBJECT_COUNT];
+
+// Analytic program of each material, indexed by MaterialId
+ShaderProgram* const materialShaders[MATERIAL_COUNT] = {
+    &cubeShader1, &cubeShader2, &cubeShader3,
+    &sphereShader1, &sphereShader2, &sphereShader3,
+    &pyramidShader1, &pyramidShader2
+};
+
+// Analytic programs specialised for a material's current parameters, built
+// on first use; the generic program above draws until the variant is ready
+const size_t MATERIAL_VARIANT_CAPACITY = 4;
+ShaderVariantCache materialVariants[MATERIAL_COUNT];
+bool specializedShaders = true;
+
+// Gallery: a stress scene filling Room 2 with up to GALLERY_MAX_OBJECTS small
+// objects, cycling through the meshes and the opaque materials with jittered
+// parameters. Instanced, each mesh and material pair is one batch drawn by the
+// INSTANCED build of the material's program; otherwise every object is its
+// own draw, for comparison.
+const int GALLERY_MAX_OBJECTS = 10000;
+const MaterialId galleryMaterials[] = {
+    MATERIAL_CUBE1, MATERIAL_CUBE2, MATERIAL_SPHERE1, MATERIAL_SPHERE2,
+    MATERIAL_SPHERE3, MATERIAL_PYRAMID1, MATERIAL_PYRAMID2
+};
+const int GALLERY_MATERIAL_COUNT = sizeof(galleryMaterials) / sizeof(galleryMaterials[0]);
+
+bool compactVertices = true;        // Arena layout, see uploadGeometryArena
+bool galleryEnabled = false;
+bool galleryInstanced = true;
+int galleryObjects = 1000;
+bool galleryStale = true;           // Instances need regenerating (count or a material changed)
+InstanceBatch galleryBatches[GALLERY_MATERIAL_COUNT][MESH_COUNT];
+// Drawn one per object, each object reads its own material block from here,
+// batch by batch, galleryMaterialStride bytes apart
+unsigned int galleryMaterialUBO;
+GLintptr galleryMaterialStride;
+GLintptr galleryMaterialOffsets[GALLERY_MATERIAL_COUNT][MESH_COUNT];   // Of each batch's first object
+float galleryObjectRadius;                      // Bounding radius of every gallery object
+int galleryLods[GALLERY_MATERIAL_COUNT];        // Level of each sphere batch
+ShaderVariantCache instancedVariants[MATERIAL_COUNT];
+ShaderProgram instancedDepthShader;
+
+// Baked noise: each material can swap its analytic noise for a 3D texture
+// baked over its object's bounds, re-baked when a noise parameter changes
+const char* const materialShaderNames[MATERIAL_COUNT] = {
+    "cube1", "cube2", "cube3",
+    "sphere1", "sphere2", "sphere3",
+    "pyramid1", "pyramid2"
+};
+
+const int BAKE_RESOLUTION = 64;
+const unsigned int BAKED_TEXTURE_UNIT_BASE = 1;     // Unit 0 is left to ImGui
+
+bool materialBaked[MATERIAL_COUNT];
+ShaderProgram bakedShaders[MATERIAL_COUNT];
+BakedVolume bakedVolumes[MATERIAL_COUNT];
+bool bakedUniformsPending[MATERIAL_COUNT];     // Volume landed before its program was linked
+
+// Bakes run on worker threads and a material draws with its analytic shader
+// while one is pending; the texture is swapped once the bake finishes.
+// Superseded and cancelled bakes wait in retiredBakes until their remaining
+// slice jobs have returned.
+JobSystem bakeJobs;
+std::unique_ptr<BakeTask> bakeTasks[MATERIAL_COUNT];
+std::vector<std::unique_ptr<BakeTask>> retiredBakes;
+UploadRing bakeUploads;
+
+// Finished bakes are also written to disk, so later runs start with them
+const char* const VOLUME_CACHE_DIRECTORY = "../cache/volumes";
+const uint64_t VOLUME_CACHE_MAX_BYTES = 64ull << 20;
+VolumeCache volumeCache;
+JobGroup cacheWrites;
+
+#ifndef ROOMS_HEADLESS
 void mouse_callback(GLFWwindow* window, double xposIn, double yposIn) {
     if (!mouseCaptured) return; 
     
@@ -179,33 +452,185 @@ void processInput(GLFWwindow* window) {
         firstPress = true;
     }
 }
+#endif
 
-unsigned int createShader(const char* vertexPath, const char* fragmentPath) {
-    std::string vertexCode = readShaderFile(vertexPath);
-    std::string fragmentCode = readShaderFile(fragmentPath);
-    const char* vertexSource = vertexCode.c_str();
-    const char* fragmentSource = fragmentCode.c_str();
+void setupFrameData(unsigned int& frameUBO) {
+    glGenBuffers(1, &frameUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), NULL, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, frameUBO);
+}
 
-    unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexSource, NULL);
-    glCompileShader(vertexShader);
+void updateFrameData(unsigned int frameUBO, const glm::mat4& view, const glm::mat4& projection, const glm::vec3& cameraPos) {
+    FrameData data;
+    data.view = view;
+    data.projection = projection;
+    data.viewPos = glm::vec4(cameraPos, 1.0f);
+    data.lightPos = glm::vec4(0.0f, 10.0f, 0.0f, 1.0f);
 
-    unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentSource, NULL);
-    glCompileShader(fragmentShader);
+    glBindBuffer(GL_UNIFORM_BUFFER, frameUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameData), &data);
+}
 
-    unsigned int shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
+void cleanupFrameData(unsigned int frameUBO) {
+    glDeleteBuffers(1, &frameUBO);
+}
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+// The std140 bytes of a material struct, zero padded to a MaterialBlock
+template <typename T>
+MaterialBlock packMaterial(const T& data) {
+    static_assert(sizeof(T) <= sizeof(MaterialBlock), "Material does not fit a MaterialBlock");
+    MaterialBlock block;
+    std::memset(&block, 0, sizeof(block));
+    std::memcpy(&block, &data, sizeof(T));
+    return block;
+}
 
-    return shaderProgram;
+// A material's current parameters, as its uniform buffer and instances hold them
+MaterialBlock materialBlock(MaterialId id) {
+    switch (id) {
+    case MATERIAL_CUBE1: {
+        Cube1Material m;
+        m.baseColor = glm::make_vec3(room1Params.cubeBaseColor);
+        m.noiseScale = room1Params.cubeNoiseScale;
+        m.noiseAmplitude = room1Params.cubeNoiseAmplitude;
+        return packMaterial(m);
+    }
+    case MATERIAL_CUBE2: {
+        Cube2Material m;
+        m.baseColor = glm::make_vec3(room2Params.cube2BaseColor);
+        m.noiseScale = room2Params.cube2NoiseScale;
+        m.noiseIntensity = room2Params.cube2NoiseIntensity;
+        return packMaterial(m);
+    }
+    case MATERIAL_CUBE3: {
+        Cube3Material m;
+        m.baseColor = glm::make_vec3(room3Params.cube3BaseColor);
+        m.noiseScale = room3Params.cube3NoiseScale;
+        m.noiseIntensity = room3Params.cube3NoiseIntensity;
+        m.minAlpha = room3Params.cube3MinAlpha;
+        m.maxAlpha = room3Params.cube3MaxAlpha;
+        return packMaterial(m);
+    }
+    case MATERIAL_SPHERE1: {
+        Sphere1Material m;
+        m.baseColor = glm::make_vec3(room1Params.sphereBaseColor);
+        m.noiseScale = room1Params.sphereNoiseScale;
+        m.noiseOffset = room1Params.sphereNoiseOffset;
+        m.noiseIntensity = room1Params.sphereNoiseIntensity;
+        return packMaterial(m);
+    }
+    case MATERIAL_SPHERE2: {
+        Sphere2Material m;
+        m.baseColor = glm::make_vec3(room2Params.sphere2BaseColor);
+        m.noiseScale = room2Params.sphere2NoiseScale;
+        m.noiseIntensity = room2Params.sphere2NoiseIntensity;
+        m.lacunarity = room2Params.sphere2Lacunarity;
+        m.octaves = room2Params.sphere2Octaves;
+        return packMaterial(m);
+    }
+    case MATERIAL_SPHERE3: {
+        Sphere3Material m;
+        m.baseColor = glm::make_vec3(room3Params.sphere3BaseColor);
+        m.noiseScale = room3Params.sphere3NoiseScale;
+        m.normalStrength = room3Params.sphere3NormalStrength;
+        m.glossiness = room3Params.sphere3Glossiness;
+        return packMaterial(m);
+    }
+    case MATERIAL_PYRAMID1: {
+        Pyramid1Material m;
+        m.baseColor1 = glm::make_vec3(room1Params.pyramidBaseColor1);
+        m.noiseTurbulence = room1Params.pyramidNoiseTurbulence;
+        m.baseColor2 = glm::make_vec3(room1Params.pyramidBaseColor2);
+        m.noiseGlow = room1Params.pyramidNoiseGlow;
+        m.colorMix = room1Params.pyramidColorMix;
+        return packMaterial(m);
+    }
+    case MATERIAL_PYRAMID2: {
+        Pyramid2Material m;
+        m.baseColor1 = glm::make_vec3(room2Params.pyramid2BaseColor1);
+        m.noiseScale = room2Params.pyramid2NoiseScale;
+        m.baseColor2 = glm::make_vec3(room2Params.pyramid2BaseColor2);
+        m.noiseIntensity = room2Params.pyramid2NoiseIntensity;
+        m.edgeThreshold = room2Params.pyramid2EdgeThreshold;
+        m.glowStrength = room2Params.pyramid2GlowStrength;
+        return packMaterial(m);
+    }
+    default:
+        return MaterialBlock();
+    }
+}
+
+void uploadMaterial(MaterialId id) {
+    MaterialBlock block = materialBlock(id);
+    glBindBuffer(GL_UNIFORM_BUFFER, materialUBOs[id]);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(block), &block, GL_DYNAMIC_DRAW);
+    frameStats.materialUploads++;
+}
+
+void setupMaterials() {
+    glGenBuffers(MATERIAL_COUNT, materialUBOs);
+    for (int i = 0; i < MATERIAL_COUNT; i++) {
+        uploadMaterial((MaterialId)i);
+        glBindBufferBase(GL_UNIFORM_BUFFER, MATERIAL_BINDING_BASE + i, materialUBOs[i]);
+        materialDirty[i] = false;
+    }
+}
+
+// Called once per frame: only materials edited since the last frame are sent
+void updateMaterials() {
+    for (int i = 0; i < MATERIAL_COUNT; i++) {
+        if (materialDirty[i]) {
+            uploadMaterial((MaterialId)i);
+            materialDirty[i] = false;
+            galleryStale = true;
+        }
+    }
+}
+
+void cleanupMaterials() {
+    glDeleteBuffers(MATERIAL_COUNT, materialUBOs);
 }
 
-void setupCorridors(unsigned int& corridorVAO, unsigned int& corridorVBO, unsigned int& corridorEBO, unsigned int& corridorShader) {
+// Rejects draws whose world-space bounds lie outside the view frustum
+bool isInFrustum(const Bounds& bounds) {
+    if (!frustumCulling || intersectsFrustum(viewFrustum, bounds)) {
+        return true;
+    }
+    frameStats.frustumCulled++;
+    return false;
+}
+
+CellRange makeCellRange(int mesh, GLsizei count, unsigned int firstIndex, int cell) {
+    CellRange range;
+    range.mesh = meshSubrange(sceneGeometry, mesh, count, firstIndex);
+    range.cell = cell;
+    return range;
+}
+
+// Cells and door openings matching the geometry in setupRooms and setupCorridors
+void setupPortals() {
+    levelPortals = PortalGraph();
+    addCell(levelPortals, glm::vec3(-5.0f, -5.0f, -5.0f), glm::vec3(5.0f, 5.0f, 5.0f));     // CELL_ROOM1
+    addCell(levelPortals, glm::vec3(5.0f, -5.0f, -0.8f), glm::vec3(10.0f, -2.5f, 0.8f));    // CELL_CORRIDOR1
+    addCell(levelPortals, glm::vec3(10.0f, -5.0f, -5.0f), glm::vec3(20.0f, 5.0f, 5.0f));    // CELL_ROOM2
+    addCell(levelPortals, glm::vec3(20.0f, -5.0f, -0.8f), glm::vec3(25.0f, -2.5f, 0.8f));   // CELL_CORRIDOR2
+    addCell(levelPortals, glm::vec3(25.0f, -5.0f, -5.0f), glm::vec3(35.0f, 5.0f, 5.0f));    // CELL_ROOM3
+
+    const float doorX[] = {5.0f, 10.0f, 20.0f, 25.0f};
+    for (int i = 0; i < 4; i++) {
+        glm::vec3 corners[4] = {
+            glm::vec3(doorX[i], -5.0f, -0.8f),
+            glm::vec3(doorX[i], -5.0f,  0.8f),
+            glm::vec3(doorX[i], -2.5f,  0.8f),
+            glm::vec3(doorX[i], -2.5f, -0.8f)
+        };
+        // Door i joins cell i to cell i + 1
+        addPortal(levelPortals, i, i + 1, corners);
+    }
+}
+
+void setupCorridors(ShaderProgram& corridorShader) {
     float corridorVertices[] = {
         // First corridor (between rooms 1 and 2)
         // Front wall 
@@ -272,54 +697,28 @@ void setupCorridors(unsigned int& corridorVAO, unsigned int& corridorVBO, unsign
         28, 29, 30, 28, 30, 31  
     };
 
-    glGenVertexArrays(1, &corridorVAO);
-    glGenBuffers(1, &corridorVBO);
-    glGenBuffers(1, &corridorEBO);
-
-    glBindVertexArray(corridorVAO);
+    int corridorMesh = addMesh(sceneGeometry, "corridors", makeVertices(corridorVertices, 32, 6), corridorIndices, 48);
 
-    glBindBuffer(GL_ARRAY_BUFFER, corridorVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(corridorVertices), corridorVertices, GL_STATIC_DRAW);
+    createShader(corridorShader, "../shaders/vertex_corridor.glsl", "../shaders/fragment_corridor.glsl");
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, corridorEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(corridorIndices), corridorIndices, GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    corridorShader = createShader("../shaders/vertex_corridor.glsl", "../shaders/fragment_corridor.glsl");
+    corridorRanges[0] = makeCellRange(corridorMesh, 24, 0, CELL_CORRIDOR1);
+    corridorRanges[1] = makeCellRange(corridorMesh, 24, 24, CELL_CORRIDOR2);
 }
 
-void renderCorridors(unsigned int corridorVAO, unsigned int corridorShader, 
-                    const glm::mat4& view, const glm::mat4& projection, 
-                    const glm::vec3& cameraPos) {
-    glUseProgram(corridorShader);
-    
-    glUniform3f(glGetUniformLocation(corridorShader, "lightPos"), 0.0f, 10.0f, 0.0f);
-    glUniform3f(glGetUniformLocation(corridorShader, "viewPos"), cameraPos.x, cameraPos.y, cameraPos.z);
-    
-    glm::mat4 corridorModel = glm::mat4(1.0f);
-    
-    glUniformMatrix4fv(glGetUniformLocation(corridorShader, "model"), 1, GL_FALSE, glm::value_ptr(corridorModel));
-    glUniformMatrix4fv(glGetUniformLocation(corridorShader, "view"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(corridorShader, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-    
-    glBindVertexArray(corridorVAO);
-    glDrawElements(GL_TRIANGLES, 48, GL_UNSIGNED_INT, 0);
+void submitCorridors(RenderQueue& queue, const ShaderProgram& corridorShader) {
+    for (const CellRange& range : corridorRanges) {
+        if (!visibility.cellVisible[range.cell] || !isInFrustum(range.mesh.bounds)) continue;
+        submitDraw(queue, PASS_OPAQUE, corridorShader, sceneGeometry.vao, range.mesh,
+                   IDENTITY_TRANSFORM, boundsCenter(range.mesh.bounds));
+    }
 }
 
-void cleanupCorridors(unsigned int corridorVAO, unsigned int corridorVBO, 
-                     unsigned int corridorEBO, unsigned int corridorShader) {
-    glDeleteVertexArrays(1, &corridorVAO);
-    glDeleteBuffers(1, &corridorVBO);
-    glDeleteBuffers(1, &corridorEBO);
-    glDeleteProgram(corridorShader);
+void cleanupCorridors(ShaderProgram& corridorShader) {
+    deleteShader(corridorShader);
 }
 
 // Cube functions
-void setupCube(unsigned int& cubeVAO, unsigned int& cubeVBO, unsigned int& cubeEBO) {
+void setupCube() {
     float cubeVertices[] = {
         
         -0.5f, -0.5f, -0.5f,  0.0f,  0.0f, -1.0f,
@@ -362,193 +761,92 @@ void setupCube(unsigned int& cubeVAO, unsigned int& cubeVBO, unsigned int& cubeE
         20,21, 22,  20,22, 23  
     };
 
-    glGenVertexArrays(1, &cubeVAO);
-    glGenBuffers(1, &cubeVBO);
-    glGenBuffers(1, &cubeEBO);
-
-    glBindVertexArray(cubeVAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(cubeVertices), cubeVertices, GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubeEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(cubeIndices), cubeIndices, GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    cubeShader1 = createShader("../shaders/vertex_cube1.glsl", "../shaders/fragment_cube1.glsl");
-    cubeShader2 = createShader("../shaders/vertex_cube2.glsl", "../shaders/fragment_cube2.glsl");
-    cubeShader3 = createShader("../shaders/vertex_cube3.glsl", "../shaders/fragment_cube3.glsl");
-
-}
-
-void renderCube(unsigned int cubeVAO, int room, const glm::mat4& view, const glm::mat4& projection, 
-                const glm::vec3& cameraPos, const glm::vec3& position, const glm::vec3& scale = glm::vec3(1.0f)) {
-    unsigned int shader;
-    if (room == 1) {
-        shader = cubeShader1;
-        glUseProgram(cubeShader1);
-        glUniform1f(glGetUniformLocation(cubeShader1, "noiseScale"), room1Params.cubeNoiseScale);
-        glUniform1f(glGetUniformLocation(cubeShader1, "noiseAmplitude"), room1Params.cubeNoiseAmplitude);
-        glUniform3fv(glGetUniformLocation(cubeShader1, "baseColor"), 1, room1Params.cubeBaseColor);
-    } else if (room == 2) {
-        shader = cubeShader2;
-        glUseProgram(cubeShader2);
-        glUniform1f(glGetUniformLocation(cubeShader2, "noiseScale"), room2Params.cube2NoiseScale);
-        glUniform1f(glGetUniformLocation(cubeShader2, "noiseIntensity"), room2Params.cube2NoiseIntensity);
-        glUniform3fv(glGetUniformLocation(cubeShader2, "baseColor"), 1, room2Params.cube2BaseColor);
-    }else {
-        shader = cubeShader3;
-        glUseProgram(cubeShader3);
-        glUniform1f(glGetUniformLocation(cubeShader3, "noiseScale"), room3Params.cube3NoiseScale);
-        glUniform1f(glGetUniformLocation(cubeShader3, "noiseIntensity"), room3Params.cube3NoiseIntensity);
-        glUniform3fv(glGetUniformLocation(cubeShader3, "baseColor"), 1, room3Params.cube3BaseColor);
-        glUniform1f(glGetUniformLocation(cubeShader3, "minAlpha"), room3Params.cube3MinAlpha);
-        glUniform1f(glGetUniformLocation(cubeShader3, "maxAlpha"), room3Params.cube3MaxAlpha);
-    }
-
-    glUseProgram(shader);
-    
-    glUniform3f(glGetUniformLocation(shader, "lightPos"), 0.0f, 10.0f, 0.0f);
-    glUniform3f(glGetUniformLocation(shader, "viewPos"), cameraPos.x, cameraPos.y, cameraPos.z);
-    
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, position);
-    model = glm::scale(model, scale);  
-    
-    glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, glm::value_ptr(model));
-    glUniformMatrix4fv(glGetUniformLocation(shader, "view"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(shader, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-    
-    glBindVertexArray(cubeVAO);
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+    objectMeshes[MESH_CUBE] = addMesh(sceneGeometry, "cube", makeVertices(cubeVertices, 24, 6), cubeIndices, 36);
+
+    createShader(cubeShader1, "../shaders/vertex_cube1.glsl", "../shaders/fragment_cube1.glsl",
+                 MATERIAL_BINDING_BASE + MATERIAL_CUBE1);
+    createShader(cubeShader2, "../shaders/vertex_cube2.glsl", "../shaders/fragment_cube2.glsl",
+                 MATERIAL_BINDING_BASE + MATERIAL_CUBE2);
+    createShader(cubeShader3, "../shaders/vertex_cube3.glsl", "../shaders/fragment_cube3.glsl",
+                 MATERIAL_BINDING_BASE + MATERIAL_CUBE3);
 }
 
-void cleanupCube(unsigned int cubeVAO, unsigned int cubeVBO, unsigned int cubeEBO) {
-    glDeleteVertexArrays(1, &cubeVAO);
-    glDeleteBuffers(1, &cubeVBO);
-    glDeleteBuffers(1, &cubeEBO);
-    glDeleteProgram(cubeShader1);
-    glDeleteProgram(cubeShader2);
-    glDeleteProgram(cubeShader3);
+void cleanupCube() {
+    deleteShader(cubeShader1);
+    deleteShader(cubeShader2);
+    deleteShader(cubeShader3);
 }
 
 // Sphere functions
-void setupSphere(unsigned int& sphereVAO, unsigned int& sphereVBO, unsigned int& sphereEBO, std::vector<unsigned int>& sphereIndices) {
-    std::vector<float> sphereVertices;
-    const unsigned int X_SEGMENTS = 32;
-    const unsigned int Y_SEGMENTS = 32;
+// UV sphere of radius 1 with the given number of segments around and from
+// pole to pole; positions double as normals
+void generateSphere(unsigned int segments, std::vector<float>& vertices, std::vector<unsigned int>& indices) {
     const float PI = 3.14159265359f;
-    
-    for(unsigned int y = 0; y <= Y_SEGMENTS; y++) {
-        for(unsigned int x = 0; x <= X_SEGMENTS; x++) {
-            float xSegment = (float)x / (float)X_SEGMENTS;
-            float ySegment = (float)y / (float)Y_SEGMENTS;
+
+    for(unsigned int y = 0; y <= segments; y++) {
+        for(unsigned int x = 0; x <= segments; x++) {
+            float xSegment = (float)x / (float)segments;
+            float ySegment = (float)y / (float)segments;
             float xPos = std::cos(xSegment * 2.0f * PI) * std::sin(ySegment * PI);
             float yPos = std::cos(ySegment * PI);
             float zPos = std::sin(xSegment * 2.0f * PI) * std::sin(ySegment * PI);
             
-            sphereVertices.push_back(xPos);
-            sphereVertices.push_back(yPos);
-            sphereVertices.push_back(zPos);
-            sphereVertices.push_back(xPos);
-            sphereVertices.push_back(yPos);
-            sphereVertices.push_back(zPos);
+            vertices.push_back(xPos);
+            vertices.push_back(yPos);
+            vertices.push_back(zPos);
+            vertices.push_back(xPos);
+            vertices.push_back(yPos);
+            vertices.push_back(zPos);
         }
     }
     
     // Generate indices
-    for(unsigned int y = 0; y < Y_SEGMENTS; y++) {
-        for(unsigned int x = 0; x < X_SEGMENTS; x++) {
-            sphereIndices.push_back(y * (X_SEGMENTS + 1) + x);
-            sphereIndices.push_back((y + 1) * (X_SEGMENTS + 1) + x);
-            sphereIndices.push_back(y * (X_SEGMENTS + 1) + x + 1);
-            sphereIndices.push_back((y + 1) * (X_SEGMENTS + 1) + x);
-            sphereIndices.push_back((y + 1) * (X_SEGMENTS + 1) + x + 1);
-            sphereIndices.push_back(y * (X_SEGMENTS + 1) + x + 1);
+    for(unsigned int y = 0; y < segments; y++) {
+        for(unsigned int x = 0; x < segments; x++) {
+            indices.push_back(y * (segments + 1) + x);
+            indices.push_back((y + 1) * (segments + 1) + x);
+            indices.push_back(y * (segments + 1) + x + 1);
+            indices.push_back((y + 1) * (segments + 1) + x);
+            indices.push_back((y + 1) * (segments + 1) + x + 1);
+            indices.push_back(y * (segments + 1) + x + 1);
         }
     }
+}
 
-    glGenVertexArrays(1, &sphereVAO);
-    glGenBuffers(1, &sphereVBO);
-    glGenBuffers(1, &sphereEBO);
-    
-    glBindVertexArray(sphereVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, sphereVBO);
-    glBufferData(GL_ARRAY_BUFFER, sphereVertices.size() * sizeof(float), sphereVertices.data(), GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sphereEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sphereIndices.size() * sizeof(unsigned int), sphereIndices.data(), GL_STATIC_DRAW);
-    
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    sphereShader1 = createShader("../shaders/vertex_sphere1.glsl", "../shaders/fragment_sphere1.glsl");
-    sphereShader2 = createShader("../shaders/vertex_sphere2.glsl", "../shaders/fragment_sphere2.glsl");
-    sphereShader3 = createShader("../shaders/vertex_sphere3.glsl", "../shaders/fragment_sphere3.glsl"); 
-
-}
-
-void renderSphere(unsigned int sphereVAO, int room, const glm::mat4& view, const glm::mat4& projection,
-                 const glm::vec3& cameraPos, const std::vector<unsigned int>& indices,
-                 const glm::vec3& position, const glm::vec3& scale = glm::vec3(1.0f)) {
-    unsigned int shader;
-    if (room == 1) {
-        shader = sphereShader1;
-        glUseProgram(sphereShader1);
-        glUniform1f(glGetUniformLocation(sphereShader1, "noiseScale"), room1Params.sphereNoiseScale);
-        glUniform1f(glGetUniformLocation(sphereShader1, "noiseOffset"), room1Params.sphereNoiseOffset);
-        glUniform1f(glGetUniformLocation(sphereShader1, "noiseIntensity"), room1Params.sphereNoiseIntensity);
-        glUniform3fv(glGetUniformLocation(sphereShader1, "baseColor"), 1, room1Params.sphereBaseColor);
-    }else if (room == 2) {
-        shader = sphereShader2;
-        glUseProgram(sphereShader2);
-        glUniform1f(glGetUniformLocation(sphereShader2, "noiseScale"), room2Params.sphere2NoiseScale);
-        glUniform1f(glGetUniformLocation(sphereShader2, "noiseIntensity"), room2Params.sphere2NoiseIntensity);
-        glUniform1f(glGetUniformLocation(sphereShader2, "lacunarity"), room2Params.sphere2Lacunarity);
-        glUniform1i(glGetUniformLocation(sphereShader2, "octaves"), room2Params.sphere2Octaves);
-        glUniform3fv(glGetUniformLocation(sphereShader2, "baseColor"), 1, room2Params.sphere2BaseColor);
-    }else {
-        shader = sphereShader3;
-        glUseProgram(sphereShader3);
-        glUniform1f(glGetUniformLocation(sphereShader3, "noiseScale"), room3Params.sphere3NoiseScale);
-        glUniform1f(glGetUniformLocation(sphereShader3, "normalStrength"), room3Params.sphere3NormalStrength);
-        glUniform3fv(glGetUniformLocation(sphereShader3, "baseColor"), 1, room3Params.sphere3BaseColor);
-        glUniform1f(glGetUniformLocation(sphereShader3, "glossiness"), room3Params.sphere3Glossiness);
-    }
-
-    glUseProgram(shader);
-    
-    glUniform3f(glGetUniformLocation(shader, "lightPos"), 0.0f, 10.0f, 0.0f);
-    glUniform3f(glGetUniformLocation(shader, "viewPos"), cameraPos.x, cameraPos.y, cameraPos.z);
-    
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, position);
-    model = glm::scale(model, scale);  
-    
-    glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, glm::value_ptr(model));
-    glUniformMatrix4fv(glGetUniformLocation(shader, "view"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(shader, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-    
-    glBindVertexArray(sphereVAO);
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+void setupSphere() {
+    std::cout << "Sphere LODs:";
+    for (int lod = 0; lod < SPHERE_LOD_COUNT; lod++) {
+        std::vector<float> sphereVertices;
+        std::vector<unsigned int> sphereIndices;
+        generateSphere(SPHERE_LOD_SEGMENTS[lod], sphereVertices, sphereIndices);
+        sphereLods[lod] = addMesh(sceneGeometry, "sphere " + std::to_string(SPHERE_LOD_SEGMENTS[lod]),
+                                  makeVertices(sphereVertices.data(), sphereVertices.size() / 6, 6),
+                                  sphereIndices.data(), sphereIndices.size());
+
+        // Used up to the radius where the next level takes over
+        sphereLodMinRadius[lod] = lod == 0 ? 0.0f : segmentsMaxRadius(SPHERE_LOD_SEGMENTS[lod - 1], LOD_MAX_ERROR);
+        std::cout << " " << SPHERE_LOD_SEGMENTS[lod] << " segments " << sphereIndices.size() / 3 << " triangles"
+                  << " (from " << sphereLodMinRadius[lod] << " px)" << (lod + 1 < SPHERE_LOD_COUNT ? "," : "");
+    }
+    std::cout << std::endl;
+    objectMeshes[MESH_SPHERE] = sphereLods[SPHERE_DEFAULT_LOD];
+
+    createShader(sphereShader1, "../shaders/vertex_sphere1.glsl", "../shaders/fragment_sphere1.glsl",
+                 MATERIAL_BINDING_BASE + MATERIAL_SPHERE1);
+    createShader(sphereShader2, "../shaders/vertex_sphere2.glsl", "../shaders/fragment_sphere2.glsl",
+                 MATERIAL_BINDING_BASE + MATERIAL_SPHERE2);
+    createShader(sphereShader3, "../shaders/vertex_sphere3.glsl", "../shaders/fragment_sphere3.glsl",
+                 MATERIAL_BINDING_BASE + MATERIAL_SPHERE3);
 }
 
-void cleanupSphere(unsigned int sphereVAO, unsigned int sphereVBO, unsigned int sphereEBO) {
-    glDeleteVertexArrays(1, &sphereVAO);
-    glDeleteBuffers(1, &sphereVBO);
-    glDeleteBuffers(1, &sphereEBO);
-    glDeleteProgram(sphereShader1);
-    glDeleteProgram(sphereShader2);
-    glDeleteProgram(sphereShader3);
+void cleanupSphere() {
+    deleteShader(sphereShader1);
+    deleteShader(sphereShader2);
+    deleteShader(sphereShader3);
 }
 
 // Pyramid functions
-void setupPyramid(unsigned int& pyramidVAO, unsigned int& pyramidVBO, unsigned int& pyramidEBO) {
+void setupPyramid() {
     float pyramidVertices[] = {
 
         -0.5f, -0.5f, -0.5f,  0.0f, -1.0f,  0.0f,
@@ -582,74 +880,20 @@ void setupPyramid(unsigned int& pyramidVAO, unsigned int& pyramidVBO, unsigned i
         13, 14, 15  
     };
 
-    glGenVertexArrays(1, &pyramidVAO);
-    glGenBuffers(1, &pyramidVBO);
-    glGenBuffers(1, &pyramidEBO);
-
-    glBindVertexArray(pyramidVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, pyramidVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(pyramidVertices), pyramidVertices, GL_STATIC_DRAW);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pyramidEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(pyramidIndices), pyramidIndices, GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    pyramidShader1 = createShader("../shaders/vertex_pyramid1.glsl", "../shaders/fragment_pyramid1.glsl");
-    pyramidShader2 = createShader("../shaders/vertex_pyramid2.glsl", "../shaders/fragment_pyramid2.glsl");
-
-}
-
-void renderPyramid(unsigned int pyramidVAO, int room, const glm::mat4& view, const glm::mat4& projection,
-                  const glm::vec3& cameraPos, const glm::vec3& position, const glm::vec3& scale = glm::vec3(1.0f)) {
-    unsigned int shader;
-    if (room == 1) {
-        shader = pyramidShader1;
-        glUseProgram(pyramidShader1);
-        glUniform1f(glGetUniformLocation(pyramidShader1, "noiseTurbulence"), room1Params.pyramidNoiseTurbulence);
-        glUniform1f(glGetUniformLocation(pyramidShader1, "noiseGlow"), room1Params.pyramidNoiseGlow);
-        glUniform1f(glGetUniformLocation(pyramidShader1, "colorMix"), room1Params.pyramidColorMix);
-        glUniform3fv(glGetUniformLocation(pyramidShader1, "baseColor1"), 1, room1Params.pyramidBaseColor1);
-        glUniform3fv(glGetUniformLocation(pyramidShader1, "baseColor2"), 1, room1Params.pyramidBaseColor2);
-    }else if (room == 2) {
-        shader = pyramidShader2;
-        glUseProgram(pyramidShader2);
-        glUniform1f(glGetUniformLocation(pyramidShader2, "noiseScale"), room2Params.pyramid2NoiseScale);
-        glUniform1f(glGetUniformLocation(pyramidShader2, "noiseIntensity"), room2Params.pyramid2NoiseIntensity);
-        glUniform1f(glGetUniformLocation(pyramidShader2, "edgeThreshold"), room2Params.pyramid2EdgeThreshold);
-        glUniform1f(glGetUniformLocation(pyramidShader2, "glowStrength"), room2Params.pyramid2GlowStrength);
-        glUniform3fv(glGetUniformLocation(pyramidShader2, "baseColor1"), 1, room2Params.pyramid2BaseColor1);
-        glUniform3fv(glGetUniformLocation(pyramidShader2, "baseColor2"), 1, room2Params.pyramid2BaseColor2);
-    }
-
-    glUseProgram(shader);
-    
-    glUniform3f(glGetUniformLocation(shader, "lightPos"), 0.0f, 10.0f, 0.0f);
-    glUniform3f(glGetUniformLocation(shader, "viewPos"), cameraPos.x, cameraPos.y, cameraPos.z);
-    
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, position);
-    model = glm::scale(model, scale); 
-    
-    glUniformMatrix4fv(glGetUniformLocation(shader, "model"), 1, GL_FALSE, glm::value_ptr(model));
-    glUniformMatrix4fv(glGetUniformLocation(shader, "view"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(shader, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-    
-    glBindVertexArray(pyramidVAO);
-    glDrawElements(GL_TRIANGLES, 18, GL_UNSIGNED_INT, 0);
+    objectMeshes[MESH_PYRAMID] = addMesh(sceneGeometry, "pyramid", makeVertices(pyramidVertices, 16, 6), pyramidIndices, 18);
+
+    createShader(pyramidShader1, "../shaders/vertex_pyramid1.glsl", "../shaders/fragment_pyramid1.glsl",
+                 MATERIAL_BINDING_BASE + MATERIAL_PYRAMID1);
+    createShader(pyramidShader2, "../shaders/vertex_pyramid2.glsl", "../shaders/fragment_pyramid2.glsl",
+                 MATERIAL_BINDING_BASE + MATERIAL_PYRAMID2);
 }
 
-void cleanupPyramid(unsigned int pyramidVAO, unsigned int pyramidVBO, unsigned int pyramidEBO) {
-    glDeleteVertexArrays(1, &pyramidVAO);
-    glDeleteBuffers(1, &pyramidVBO);
-    glDeleteBuffers(1, &pyramidEBO);
-    glDeleteProgram(pyramidShader1);
-    glDeleteProgram(pyramidShader2);
+void cleanupPyramid() {
+    deleteShader(pyramidShader1);
+    deleteShader(pyramidShader2);
 }
 
-void setupDoorFrames(unsigned int& doorVAO, unsigned int& doorVBO, unsigned int& doorEBO, unsigned int& doorShader) {
+void setupDoorFrames(ShaderProgram& doorShader) {
     float vertices[] = {
         // Above door section for Room 1 right wall
         5.0f, -2.5f, -0.8f,     
@@ -694,44 +938,72 @@ void setupDoorFrames(unsigned int& doorVAO, unsigned int& doorVBO, unsigned int&
         13, 15, 14
     };
 
-    glGenVertexArrays(1, &doorVAO);
-    glGenBuffers(1, &doorVBO);
-    glGenBuffers(1, &doorEBO);
+    int doorMesh = addMesh(sceneGeometry, "doors", makeVertices(vertices, 16, 3), indices, 24);
 
-    glBindVertexArray(doorVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, doorVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    createShader(doorShader, "../shaders/vertex_left.glsl", "../shaders/fragment_left.glsl");
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, doorEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+    // Each section above a door belongs to the room whose wall it fills
+    doorFrameRanges[0] = makeCellRange(doorMesh, 6, 0, CELL_ROOM1);
+    doorFrameRanges[1] = makeCellRange(doorMesh, 6, 6, CELL_ROOM2);
+    doorFrameRanges[2] = makeCellRange(doorMesh, 6, 12, CELL_ROOM2);
+    doorFrameRanges[3] = makeCellRange(doorMesh, 6, 18, CELL_ROOM3);
+}
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+void submitDoorFrames(RenderQueue& queue, const ShaderProgram& doorShader) {
+    for (const CellRange& range : doorFrameRanges) {
+        if (!visibility.cellVisible[range.cell] || !isInFrustum(range.mesh.bounds)) continue;
+        submitDraw(queue, PASS_OPAQUE, doorShader, sceneGeometry.vao, range.mesh,
+                   IDENTITY_TRANSFORM, boundsCenter(range.mesh.bounds));
+    }
+}
 
-    doorShader = createShader("../shaders/vertex_left.glsl", "../shaders/fragment_left.glsl");
+void cleanupDoorFrames(ShaderProgram& doorShader) {
+    deleteShader(doorShader);
 }
 
-void renderDoorFrames(unsigned int doorVAO, unsigned int doorShader, const glm::mat4& view, const glm::mat4& projection) {
-    glUseProgram(doorShader);
-    glUniformMatrix4fv(glGetUniformLocation(doorShader, "view"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(doorShader, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-    
-    glm::mat4 model = glm::mat4(1.0f);
-    glUniformMatrix4fv(glGetUniformLocation(doorShader, "model"), 1, GL_FALSE, glm::value_ptr(model));
+// Index ranges of the room geometry in setupRooms' index buffer, the wall,
+// ceiling or floor program each one is drawn with and the room it bounds
+struct RoomFace {
+    int shader;
+    GLsizei count;
+    unsigned int firstIndex;
+    int cell;
+};
 
-    glBindVertexArray(doorVAO);
-    
-    glDrawElements(GL_TRIANGLES, 24, GL_UNSIGNED_INT, 0);
-}
+const RoomFace roomFaces[] = {
+    // Room 1
+    {0, 6, 0, CELL_ROOM1},      // Front face
+    {1, 6, 6, CELL_ROOM1},      // Back face
+    {2, 6, 12, CELL_ROOM1},     // Left face
+    {3, 18, 18, CELL_ROOM1},    // Right face (with door)
 
-void cleanupDoorFrames(unsigned int doorVAO, unsigned int doorVBO, unsigned int doorEBO, unsigned int doorShader) {
-    glDeleteVertexArrays(1, &doorVAO);
-    glDeleteBuffers(1, &doorVBO);
-    glDeleteBuffers(1, &doorEBO);
-    glDeleteProgram(doorShader);
-}
+    // Room 2
+    {0, 6, 36, CELL_ROOM2},     // Front face
+    {1, 6, 42, CELL_ROOM2},     // Back face
+    {2, 18, 48, CELL_ROOM2},    // Left face (with door)
+    {3, 18, 66, CELL_ROOM2},    // Right face (with door)
 
-void setupRooms(unsigned int& VAO, unsigned int& VBO, unsigned int& EBO, unsigned int shaderPrograms[]) {
+    // Room 3
+    {0, 6, 84, CELL_ROOM3},     // Front face
+    {1, 6, 90, CELL_ROOM3},     // Back face
+    {2, 18, 96, CELL_ROOM3},    // Left face (with door)
+    {3, 6, 114, CELL_ROOM3},    // Right face
+
+    // Ceilings
+    {4, 6, 120, CELL_ROOM1},
+    {4, 6, 126, CELL_ROOM2},
+    {4, 6, 132, CELL_ROOM3},
+
+    // Floors
+    {5, 6, 138, CELL_ROOM1},
+    {5, 6, 144, CELL_ROOM2},
+    {5, 6, 150, CELL_ROOM3}
+};
+
+const int ROOM_FACE_COUNT = sizeof(roomFaces) / sizeof(roomFaces[0]);
+MeshRange roomFaceRanges[ROOM_FACE_COUNT];
+
+void setupRooms(ShaderProgram shaderPrograms[]) {
     float vertices[] = {
         // Room 1
         // Front face
@@ -967,232 +1239,779 @@ void setupRooms(unsigned int& VAO, unsigned int& VBO, unsigned int& EBO, unsigne
         92, 94, 95
     };
 
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
+    int roomMesh = addMesh(sceneGeometry, "rooms",
+                           makeVertices(vertices, sizeof(vertices) / sizeof(vertices[0]) / 3, 3), indices,
+                           sizeof(indices) / sizeof(indices[0]));
 
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-    
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+    createShader(shaderPrograms[0], "../shaders/vertex_front.glsl", "../shaders/fragment_front.glsl");
+    createShader(shaderPrograms[1], "../shaders/vertex_back.glsl", "../shaders/fragment_back.glsl");
+    createShader(shaderPrograms[2], "../shaders/vertex_left.glsl", "../shaders/fragment_left.glsl");
+    createShader(shaderPrograms[3], "../shaders/vertex_right.glsl", "../shaders/fragment_right.glsl");
+    createShader(shaderPrograms[4], "../shaders/vertex_top.glsl", "../shaders/fragment_top.glsl");
+    createShader(shaderPrograms[5], "../shaders/vertex_bottom.glsl", "../shaders/fragment_bottom.glsl");
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+    for (int i = 0; i < ROOM_FACE_COUNT; i++) {
+        roomFaceRanges[i] = meshSubrange(sceneGeometry, roomMesh, roomFaces[i].count, roomFaces[i].firstIndex);
+    }
+}
+
+void submitRooms(RenderQueue& queue, const ShaderProgram shaderPrograms[]) {
+    for (int i = 0; i < ROOM_FACE_COUNT; i++) {
+        const RoomFace& face = roomFaces[i];
+        if (!visibility.cellVisible[face.cell] || !isInFrustum(roomFaceRanges[i].bounds)) continue;
+        submitDraw(queue, PASS_OPAQUE, shaderPrograms[face.shader], sceneGeometry.vao, roomFaceRanges[i],
+                   IDENTITY_TRANSFORM, boundsCenter(roomFaceRanges[i].bounds));
+    }
+}
 
-    shaderPrograms[0] = createShader("../shaders/vertex_front.glsl", "../shaders/fragment_front.glsl");
-    shaderPrograms[1] = createShader("../shaders/vertex_back.glsl", "../shaders/fragment_back.glsl");
-    shaderPrograms[2] = createShader("../shaders/vertex_left.glsl", "../shaders/fragment_left.glsl");
-    shaderPrograms[3] = createShader("../shaders/vertex_right.glsl", "../shaders/fragment_right.glsl");
-    shaderPrograms[4] = createShader("../shaders/vertex_top.glsl", "../shaders/fragment_top.glsl");
-    shaderPrograms[5] = createShader("../shaders/vertex_bottom.glsl", "../shaders/fragment_bottom.glsl");
+void cleanupRooms(ShaderProgram shaderPrograms[]) {
+    for (int i = 0; i < 6; i++) {
+        deleteShader(shaderPrograms[i]);
+    }
 }
 
-void renderRooms(unsigned int VAO, unsigned int shaderPrograms[], const glm::mat4& view, const glm::mat4& projection) {
+glm::mat4 objectModel(const SceneObject& object) {
     glm::mat4 model = glm::mat4(1.0f);
+    model = glm::translate(model, object.position);
+    model = glm::scale(model, object.scale);
+    return model;
+}
 
-    // Room 1
-    // Front face 
-    glUseProgram(shaderPrograms[0]);
-    glUniformMatrix4fv(glGetUniformLocation(shaderPrograms[0], "view"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(shaderPrograms[0], "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-    glUniformMatrix4fv(glGetUniformLocation(shaderPrograms[0], "model"), 1, GL_FALSE, glm::value_ptr(model));
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-
-    // Back face
-    glUseProgram(shaderPrograms[1]);
-    glUniformMatrix4fv(glGetUniformLocation(shaderPrograms[1], "view"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(shaderPrograms[1], "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-    glUniformMatrix4fv(glGetUniformLocation(shaderPrograms[1], "model"), 1, GL_FALSE, glm::value_ptr(model));
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(6 * sizeof(unsigned int)));
-
-    // Left face
-    glUseProgram(shaderPrograms[2]);
-    glUniformMatrix4fv(glGetUniformLocation(shaderPrograms[2], "view"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(shaderPrograms[2], "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-    glUniformMatrix4fv(glGetUniformLocation(shaderPrograms[2], "model"), 1, GL_FALSE, glm::value_ptr(model));
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(12 * sizeof(unsigned int)));
-
-    // Right face (with door)
-    glUseProgram(shaderPrograms[3]);
-    glUniformMatrix4fv(glGetUniformLocation(shaderPrograms[3], "view"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(shaderPrograms[3], "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-    glUniformMatrix4fv(glGetUniformLocation(shaderPrograms[3], "model"), 1, GL_FALSE, glm::value_ptr(model));
-    glDrawElements(GL_TRIANGLES, 18, GL_UNSIGNED_INT, (void*)(18 * sizeof(unsigned int)));
+// The objects never move, so their transforms are computed once at startup
+void setupObjectTransforms() {
+    for (size_t i = 0; i < OBJECT_COUNT; i++) {
+        objectTransforms[i].model = objectModel(sceneObjects[i]);
+        objectLods[i] = SPHERE_DEFAULT_LOD;
+    }
+    updateNormalMatrices(objectTransforms, OBJECT_COUNT);
+}
 
-    // Room 2
-    // Front face 
-    glUseProgram(shaderPrograms[0]);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(36 * sizeof(unsigned int)));
+// The #defines a material's analytic program is specialised with; empty for
+// materials with nothing to specialise
+ShaderDefines materialDefines(MaterialId id) {
+    ShaderDefines defines;
+    if (id == MATERIAL_SPHERE2) {
+        defines.push_back({"OCTAVES", std::to_string(room2Params.sphere2Octaves)});
+    }
+    return defines;
+}
+
+const ShaderProgram& analyticShader(MaterialId id) {
+    if (specializedShaders) {
+        ShaderDefines defines = materialDefines(id);
+        if (!defines.empty()) {
+            const ShaderProgram* variant = findShaderVariant(materialVariants[id], defines);
+            if (variant) return *variant;
+        }
+    }
+    return *materialShaders[id];
+}
 
-    // Back face
-    glUseProgram(shaderPrograms[1]);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(42 * sizeof(unsigned int)));
+void submitObjects(RenderQueue& queue) {
+    for (size_t i = 0; i < OBJECT_COUNT; i++) {
+        const SceneObject& object = sceneObjects[i];
+        if (!visibility.cellVisible[object.cell]) continue;
 
-    // Left face (with door)
-    glUseProgram(shaderPrograms[2]);
-    glDrawElements(GL_TRIANGLES, 18, GL_UNSIGNED_INT, (void*)(48 * sizeof(unsigned int)));
+        const Transform& transform = objectTransforms[i];
+        if (!isInFrustum(transformBounds(objectMesh(object.mesh).bounds, transform.model))) continue;
+
+        int lod = 0;
+        if (object.mesh == MESH_SPHERE) {
+            float radius = std::max(object.scale.x, std::max(object.scale.y, object.scale.z));
+            lod = updateSphereLod(objectLods[i], object.position, radius, 1);
+        }
+        const MeshRange& mesh = objectMeshLod(object.mesh, lod);
+
+        // Analytic while the volume is missing or stale, or its program still building
+        bool baked = materialBaked[object.material] && bakedVolumes[object.material].texture != 0
+                     && !bakeTasks[object.material] && bakedShaders[object.material].ready
+                     && !bakedUniformsPending[object.material];
+        const ShaderProgram& shader = baked ? bakedShaders[object.material] : analyticShader(object.material);
+        // The gallery binds per-object ranges at the same binding points
+        submitDraw(queue, object.pass, shader, sceneGeometry.vao, mesh, transform, object.position,
+                   materialUBOs[object.material]);
+    }
+}
 
-    // Right face (with door)
-    glUseProgram(shaderPrograms[3]);
-    glDrawElements(GL_TRIANGLES, 18, GL_UNSIGNED_INT, (void*)(66 * sizeof(unsigned int)));
+ShaderDefines instancedDefines() {
+    ShaderDefines defines;
+    defines.push_back({"INSTANCED", "1"});
+    return defines;
+}
 
-    // Room 3
-    // Front face 
-    glUseProgram(shaderPrograms[0]);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(84 * sizeof(unsigned int)));
+// NULL until the material's INSTANCED program has been built
+const ShaderProgram* instancedShader(MaterialId id) {
+    return findShaderVariant(instancedVariants[id], instancedDefines());
+}
 
-    // Back face
-    glUseProgram(shaderPrograms[1]);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(90 * sizeof(unsigned int)));
+void scaleMaterialFloat(MaterialBlock& block, int word, float factor) {
+    float value;
+    std::memcpy(&value, &block.words[word], sizeof(float));
+    value *= factor;
+    std::memcpy(&block.words[word], &value, sizeof(float));
+}
 
-    // Left face (with door)
-    glUseProgram(shaderPrograms[2]);
-    glDrawElements(GL_TRIANGLES, 18, GL_UNSIGNED_INT, (void*)(96 * sizeof(unsigned int)));
+// Deterministic value in [0, 1), so every run builds the same gallery
+float galleryJitter(uint32_t object, uint32_t salt) {
+    uint32_t h = object * 2654435761u ^ salt * 2246822519u;
+    h ^= h >> 15;
+    h *= 2246822519u;
+    h ^= h >> 13;
+    return (h & 0xffffff) / 16777216.0f;
+}
 
-    // Right face 
-    glUseProgram(shaderPrograms[3]);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(114 * sizeof(unsigned int)));
+// Lays the objects out on a cubic grid in the far part of Room 2 and sends each batch's
+// instances to the GPU
+void buildGallery() {
+    for (InstanceBatch (&row)[MESH_COUNT] : galleryBatches) {
+        for (InstanceBatch& batch : row) batch.instances.clear();
+    }
 
-    // Ceilings
-    glUseProgram(shaderPrograms[4]);
-    glUniformMatrix4fv(glGetUniformLocation(shaderPrograms[4], "view"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(shaderPrograms[4], "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-    glUniformMatrix4fv(glGetUniformLocation(shaderPrograms[4], "model"), 1, GL_FALSE, glm::value_ptr(model));
-    
-    // Room 1 ceiling
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(120 * sizeof(unsigned int)));
-    // Room 2 ceiling
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(126 * sizeof(unsigned int)));
-    // Room 3 ceiling
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(132 * sizeof(unsigned int)));
+    int side = (int)std::ceil(std::cbrt((float)galleryObjects));
+    float spacing = 7.0f / side;
+    for (int i = 0; i < galleryObjects; i++) {
+        int mesh = i % MESH_COUNT;
+        int material = (i / MESH_COUNT) % GALLERY_MATERIAL_COUNT;
+        glm::vec3 cell((float)(i % side), (float)(i / side % side), (float)(i / (side * side)));
+
+        InstanceData instance;
+        glm::mat4& model = instance.transform.model;
+        model = glm::translate(glm::mat4(1.0f), glm::vec3(12.5f, -4.5f, -3.5f) + (cell + 0.5f) * spacing);
+        model = glm::scale(model, glm::vec3(spacing * 0.35f));
+        galleryObjectRadius = spacing * 0.35f;
+
+        // Every block starts with a colour and a float; Sphere 2 also gets
+        // its own octave count
+        instance.material = materialBlock(galleryMaterials[material]);
+        for (int word = 0; word < 3; word++) {
+            scaleMaterialFloat(instance.material, word, 0.6f + 0.4f * galleryJitter(i, word));
+        }
+        scaleMaterialFloat(instance.material, 3, 0.75f + 0.5f * galleryJitter(i, 3));
+        if (galleryMaterials[material] == MATERIAL_SPHERE2) {
+            instance.material.words[6] = 1 + i % 8;
+        }
+        galleryBatches[material][mesh].instances.push_back(instance);
+    }
 
-    // Floors
-    glUseProgram(shaderPrograms[5]);
-    glUniformMatrix4fv(glGetUniformLocation(shaderPrograms[5], "view"), 1, GL_FALSE, glm::value_ptr(view));
-    glUniformMatrix4fv(glGetUniformLocation(shaderPrograms[5], "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-    glUniformMatrix4fv(glGetUniformLocation(shaderPrograms[5], "model"), 1, GL_FALSE, glm::value_ptr(model));
-    
-    // Room 1 floor
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(138 * sizeof(unsigned int)));
-    // Room 2 floor
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(144 * sizeof(unsigned int)));
-    // Room 3 floor
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)(150 * sizeof(unsigned int)));
-}
-
-void cleanupRooms(unsigned int VAO, unsigned int VBO, unsigned int EBO, unsigned int shaderPrograms[]) {
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
-    for (int i = 0; i < 6; i++) {
-        glDeleteProgram(shaderPrograms[i]);
+    // The same blocks again for drawing one object at a time
+    std::vector<unsigned char> materials((size_t)galleryObjects * galleryMaterialStride);
+    GLintptr offset = 0;
+    for (int m = 0; m < GALLERY_MATERIAL_COUNT; m++) {
+        for (int mesh = 0; mesh < MESH_COUNT; mesh++) {
+            InstanceBatch& batch = galleryBatches[m][mesh];
+            uploadInstances(batch);
+            galleryMaterialOffsets[m][mesh] = offset;
+            for (const InstanceData& instance : batch.instances) {
+                std::memcpy(&materials[offset], &instance.material, sizeof(MaterialBlock));
+                offset += galleryMaterialStride;
+            }
+        }
     }
+    glBindBuffer(GL_UNIFORM_BUFFER, galleryMaterialUBO);
+    glBufferData(GL_UNIFORM_BUFFER, materials.size(), materials.data(), GL_STATIC_DRAW);
+    galleryStale = false;
 }
 
-void renderObjects(unsigned int cubeVAO, unsigned int sphereVAO, unsigned int pyramidVAO,
-                  const glm::mat4& view, const glm::mat4& projection, const glm::vec3& cameraPos,
-                  const std::vector<unsigned int>& sphereIndices) {
-    
-    // Room 1 objects 
-    renderCube(cubeVAO, 1, view, projection, cameraPos, glm::vec3(-3.0f, -3.0f, 3.0f));
-    renderSphere(sphereVAO, 1, view, projection, cameraPos, sphereIndices, glm::vec3(0.0f, -3.0f, 0.0f));
-    renderPyramid(pyramidVAO, 1, view, projection, cameraPos, glm::vec3(-3.0f, -3.0f, -3.0f));
+void submitGallery(RenderQueue& queue) {
+    if (!galleryEnabled || !visibility.cellVisible[CELL_ROOM2]) return;
+    if (galleryStale) buildGallery();
+
+    for (int m = 0; m < GALLERY_MATERIAL_COUNT; m++) {
+        MaterialId id = galleryMaterials[m];
+        // Instanced programs build in the background; their batches show up once ready
+        const ShaderProgram* shader = galleryInstanced ? instancedShader(id) : NULL;
+        if (galleryInstanced && (!shader || (depthPrepass && !instancedDepthShader.ready))) continue;
+
+        for (int mesh = 0; mesh < MESH_COUNT; mesh++) {
+            const InstanceBatch& batch = galleryBatches[m][mesh];
+            if (batch.instances.empty() || !isInFrustum(batch.bounds)) continue;
+
+            // A sphere batch takes the level its nearest possible sphere needs
+            const MeshRange* range = &batch.mesh;
+            if (mesh == MESH_SPHERE) {
+                glm::vec3 nearest = glm::clamp(cameraPos, batch.bounds.min, batch.bounds.max);
+                int lod = updateSphereLod(galleryLods[m], nearest, galleryObjectRadius,
+                                          (unsigned int)batch.instances.size());
+                range = &objectMeshLod(MESH_SPHERE, lod);
+            }
 
-    // Room 2 objects 
-    renderCube(cubeVAO, 2, view, projection, cameraPos, glm::vec3(12.0f, -3.0f, 3.0f));
-    renderSphere(sphereVAO, 2, view, projection, cameraPos, sphereIndices, glm::vec3(15.0f, -3.0f, 0.0f));
-    renderPyramid(pyramidVAO, 2, view, projection, cameraPos, glm::vec3(18.0f, -3.0f, -3.0f));
+            if (galleryInstanced) {
+                submitInstancedDraw(queue, PASS_OPAQUE, *shader, batch.vao, *range,
+                                    (GLsizei)batch.instances.size(), 0.5f * (batch.bounds.min + batch.bounds.max));
+                continue;
+            }
+            // One draw per object, with its own material block. The generic
+            // program, as the instanced one, reads the octave count from it.
+            for (size_t i = 0; i < batch.instances.size(); i++) {
+                const InstanceData& instance = batch.instances[i];
+                if (!isInFrustum(transformBounds(range->bounds, instance.transform.model))) continue;
+                submitDraw(queue, PASS_OPAQUE, *materialShaders[id], sceneGeometry.vao, *range, instance.transform,
+                           glm::vec3(instance.transform.model[3]), galleryMaterialUBO,
+                           galleryMaterialOffsets[m][mesh] + (GLintptr)i * galleryMaterialStride);
+            }
+        }
+    }
+}
+
+void setupGallery() {
+    for (int m = 0; m < GALLERY_MATERIAL_COUNT; m++) {
+        for (int mesh = 0; mesh < MESH_COUNT; mesh++) {
+            initInstanceBatch(galleryBatches[m][mesh], sceneGeometry, objectMeshes[mesh]);
+        }
+        galleryLods[m] = SPHERE_DEFAULT_LOD;
+    }
+    GLint alignment = 1;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    galleryMaterialStride = (sizeof(MaterialBlock) + alignment - 1) / alignment * alignment;
+    glGenBuffers(1, &galleryMaterialUBO);
+    createShader(instancedDepthShader, "../shaders/vertex_depth.glsl", "../shaders/fragment_depth.glsl", -1,
+                 instancedDefines());
+}
+
+// Re-uploads the arena in the compact or the float layout; the instance
+// VAOs read it too, so they are pointed at the new layout
+void setVertexFormat(bool compact) {
+    uploadGeometryArena(sceneGeometry, compact);
+    for (InstanceBatch (&row)[MESH_COUNT] : galleryBatches) {
+        for (InstanceBatch& batch : row) {
+            glBindVertexArray(batch.vao);
+            bindArenaVertices(sceneGeometry);
+        }
+    }
+    glBindVertexArray(0);
+}
+
+void cleanupGallery() {
+    for (InstanceBatch (&row)[MESH_COUNT] : galleryBatches) {
+        for (InstanceBatch& batch : row) destroyInstanceBatch(batch);
+    }
+    glDeleteBuffers(1, &galleryMaterialUBO);
+    deleteShader(instancedDepthShader);
+}
+
+// What a material's baked volume holds: the part of its noise that depends
+// only on noise parameters, and a key over exactly those parameters. Colours
+// and other shading parameters stay live in the Material block.
+struct NoiseFieldDesc {
+    uint64_t key;
+    int channels;
+    NoiseField field;
+};
+
+template <typename T>
+uint64_t hashParams(MaterialId id, const T& params) {
+    uint64_t key = hashBytes(&id, sizeof(id));
+    return hashBytes(&params, sizeof(params), key);
+}
+
+NoiseFieldDesc describeNoiseField(MaterialId id) {
+    NoiseFieldDesc desc;
+    desc.channels = 1;
+    switch (id) {
+    case MATERIAL_CUBE1: {
+        float scale = room1Params.cubeNoiseScale;
+        desc.key = hashParams(id, scale);
+        desc.field = [scale](const NoiseSamples& samples, float* const* out) {
+            NoiseSamples p;
+            transformSamples(samples, scale, glm::vec3(0.0f), p);
+            fbmNoiseBatch(p.x.data(), p.y.data(), p.z.data(), out[0], p.size());
+        };
+        break;
+    }
+    case MATERIAL_CUBE2: {
+        float scale = room2Params.cube2NoiseScale;
+        desc.key = hashParams(id, scale);
+        desc.field = [scale](const NoiseSamples& samples, float* const* out) {
+            NoiseSamples p;
+            transformSamples(samples, scale, glm::vec3(0.0f), p);
+            simplexNoiseBatch(p.x.data(), p.y.data(), p.z.data(), out[0], p.size());
+        };
+        break;
+    }
+    case MATERIAL_CUBE3: {
+        float scale = room3Params.cube3NoiseScale;
+        desc.key = hashParams(id, scale);
+        desc.field = [scale](const NoiseSamples& samples, float* const* out) {
+            NoiseSamples p;
+            transformSamples(samples, scale, glm::vec3(0.0f), p);
+            perlinNoiseBatch(p.x.data(), p.y.data(), p.z.data(), out[0], p.size());
+        };
+        break;
+    }
+    case MATERIAL_SPHERE1: {
+        float scale = room1Params.sphereNoiseScale;
+        desc.key = hashParams(id, scale);
+        desc.field = [scale](const NoiseSamples& samples, float* const* out) {
+            NoiseSamples p;
+            transformSamples(samples, scale, glm::vec3(0.0f), p);
+            perlinNoiseBatch(p.x.data(), p.y.data(), p.z.data(), out[0], p.size());
+        };
+        break;
+    }
+    case MATERIAL_SPHERE2: {
+        struct { float scale; float lacunarity; int octaves; } params = {
+            room2Params.sphere2NoiseScale, room2Params.sphere2Lacunarity, room2Params.sphere2Octaves
+        };
+        desc.key = hashParams(id, params);
+        desc.field = [params](const NoiseSamples& samples, float* const* out) {
+            NoiseSamples p;
+            transformSamples(samples, params.scale, glm::vec3(0.0f), p);
+            multifractalNoiseBatch(p.x.data(), p.y.data(), p.z.data(), out[0], p.size(),
+                                   params.lacunarity, params.octaves);
+        };
+        break;
+    }
+    case MATERIAL_SPHERE3: {
+        // The shader perturbs the normal by differences against two offset samples
+        float scale = room3Params.sphere3NoiseScale;
+        desc.key = hashParams(id, scale);
+        desc.channels = 2;
+        desc.field = [scale](const NoiseSamples& samples, float* const* out) {
+            NoiseSamples p, offset;
+            transformSamples(samples, scale, glm::vec3(0.0f), p);
+            std::vector<float> n(p.size()), shifted(p.size());
+            perlinNoiseBatch(p.x.data(), p.y.data(), p.z.data(), n.data(), p.size());
+
+            transformSamples(p, 1.0f, glm::vec3(0.1f, 0.0f, 0.0f), offset);
+            perlinNoiseBatch(offset.x.data(), offset.y.data(), offset.z.data(), shifted.data(), p.size());
+            for (size_t i = 0; i < p.size(); i++) out[0][i] = n[i] - shifted[i];
+
+            transformSamples(p, 1.0f, glm::vec3(0.0f, 0.1f, 0.0f), offset);
+            perlinNoiseBatch(offset.x.data(), offset.y.data(), offset.z.data(), shifted.data(), p.size());
+            for (size_t i = 0; i < p.size(); i++) out[1][i] = n[i] - shifted[i];
+        };
+        break;
+    }
+    case MATERIAL_PYRAMID1: {
+        float turbulence = room1Params.pyramidNoiseTurbulence;
+        desc.key = hashParams(id, turbulence);
+        desc.field = [turbulence](const NoiseSamples& samples, float* const* out) {
+            NoiseSamples p;
+            transformSamples(samples, turbulence, glm::vec3(0.0f), p);
+            turbulenceNoiseBatch(p.x.data(), p.y.data(), p.z.data(), out[0], p.size());
+        };
+        break;
+    }
+    case MATERIAL_PYRAMID2: {
+        // Both cellular layers, so the intensity slider only changes the mix
+        float scale = room2Params.pyramid2NoiseScale;
+        desc.key = hashParams(id, scale);
+        desc.channels = 2;
+        desc.field = [scale](const NoiseSamples& samples, float* const* out) {
+            NoiseSamples p, layer2;
+            transformSamples(samples, scale, glm::vec3(0.0f), p);
+            cellularNoiseBatch(p.x.data(), p.y.data(), p.z.data(), out[0], p.size());
+            transformSamples(p, 2.0f, glm::vec3(5.0f), layer2);
+            cellularNoiseBatch(layer2.x.data(), layer2.y.data(), layer2.z.data(), out[1], p.size());
+        };
+        break;
+    }
+    default:
+        desc.key = 0;
+        break;
+    }
+    return desc;
+}
+
+// World-space bounds of the object wearing a material
+Bounds materialBounds(MaterialId id) {
+    for (const SceneObject& object : sceneObjects) {
+        if (object.material == id) {
+            return transformBounds(objectMesh(object.mesh).bounds, objectModel(object));
+        }
+    }
+    return Bounds();
+}
+
+// The volume's placement only changes with a re-bake, so it lives in plain
+// uniforms rather than the per-frame data. A program still building gets
+// them from updateBakedNoise once it is ready; the render thread never waits.
+void applyVolumeUniforms(MaterialId id) {
+    const BakedVolume& volume = bakedVolumes[id];
+    const ShaderProgram& shader = bakedShaders[id];
+    bakedUniformsPending[id] = !shader.ready;
+    if (!shader.ready) return;
+    glUseProgram(shader.id);
+    glUniform1i(shader.uniforms[UNIFORM_BAKED_NOISE], BAKED_TEXTURE_UNIT_BASE + id);
+    glUniform3fv(shader.uniforms[UNIFORM_BAKED_MIN], 1, glm::value_ptr(volume.bounds.min));
+    glm::vec3 invSize = 1.0f / (volume.bounds.max - volume.bounds.min);
+    glUniform3fv(shader.uniforms[UNIFORM_BAKED_INV_SIZE], 1, glm::value_ptr(invSize));
+}
+
+// Brings a material's volume up to date with its noise parameters: from the
+// disk cache when it has the volume, otherwise by starting a bake (and
+// abandoning one already running for older parameters)
+void bakeMaterial(MaterialId id) {
+    NoiseFieldDesc desc = describeNoiseField(id);
+
+    // Placement and resolution go into the key too, so cached volumes do
+    // not outlive a change to the scene
+    Bounds bounds = materialBounds(id);
+    int resolution = BAKE_RESOLUTION;
+    uint64_t key = hashBytes(&bounds, sizeof(bounds), desc.key);
+    key = hashBytes(&resolution, sizeof(resolution), key);
+
+    std::unique_ptr<BakeTask>& task = bakeTasks[id];
+    if (task) {
+        if (task->key == key) return;
+        cancelBake(*task);
+        retiredBakes.push_back(std::move(task));
+    }
+    if (bakedVolumes[id].key == key) {
+        return;
+    }
+
+    MappedVolume cached;
+    if (mapCachedVolume(volumeCache, materialShaderNames[id], id, key, cached)) {
+        uploadVolume(bakedVolumes[id], cached.data, bakeUploads, BAKED_TEXTURE_UNIT_BASE + id);
+        unmapCachedVolume(cached);
+        applyVolumeUniforms(id);
+        frameStats.volumeCacheHits++;
+        return;
+    }
+
+    task.reset(new BakeTask());
+    task->key = key;
+    task->bounds = bounds;
+    task->size = glm::ivec3(resolution);
+    task->channels = desc.channels;
+    task->field = desc.field;
+    startBake(bakeJobs, *task);
+}
+
+void finishBake(MaterialId id) {
+    BakeTask& task = *bakeTasks[id];
+    uploadVolume(bakedVolumes[id], bakedData(task), bakeUploads, BAKED_TEXTURE_UNIT_BASE + id);
+    applyVolumeUniforms(id);
+
+    // The voxels move into the job, which writes them out off the render thread
+    VolumeData data = bakedData(task);
+    submitJob(bakeJobs, cacheWrites, [id, data, voxels = std::move(task.voxels)]() mutable {
+        data.voxels = voxels.data();
+        writeCachedVolume(volumeCache, materialShaderNames[id], id, data);
+    });
+    bakeTasks[id].reset();
+}
+
+void setupBakedNoise() {
+    for (int i = 0; i < MATERIAL_COUNT; i++) {
+        std::string vertexPath = std::string("../shaders/vertex_") + materialShaderNames[i] + ".glsl";
+        std::string fragmentPath = std::string("../shaders/fragment_") + materialShaderNames[i] + "_baked.glsl";
+        createShader(bakedShaders[i], vertexPath.c_str(), fragmentPath.c_str(), MATERIAL_BINDING_BASE + i);
+    }
+    startJobSystem(bakeJobs, defaultWorkerCount());
+    createUploadRing(bakeUploads);
+    openVolumeCache(volumeCache, VOLUME_CACHE_DIRECTORY, VOLUME_CACHE_MAX_BYTES);
+}
+
+// Called once per frame: starts bakes for materials switched to baked mode
+// whose noise parameters changed, and uploads the bakes that have finished
+void updateBakedNoise() {
+    for (int i = 0; i < MATERIAL_COUNT; i++) {
+        if (materialBaked[i]) {
+            bakeMaterial((MaterialId)i);
+        }
+        if (bakeTasks[i] && bakeFinished(*bakeTasks[i])) {
+            finishBake((MaterialId)i);
+        }
+        if (bakedUniformsPending[i] && bakedShaders[i].ready) {
+            applyVolumeUniforms((MaterialId)i);
+        }
+    }
+    retiredBakes.erase(std::remove_if(retiredBakes.begin(), retiredBakes.end(),
+                                      [](const std::unique_ptr<BakeTask>& task) { return bakeFinished(*task); }),
+                       retiredBakes.end());
+}
+
+// Blocks until every pending bake is uploaded, helping with the slices
+void finishBakedNoise() {
+    updateBakedNoise();
+    for (int i = 0; i < MATERIAL_COUNT; i++) {
+        if (bakeTasks[i]) {
+            waitForGroup(bakeJobs, bakeTasks[i]->group);
+        }
+    }
+    updateBakedNoise();
+}
+
+void cancelMaterialBake(MaterialId id) {
+    if (bakeTasks[id]) {
+        cancelBake(*bakeTasks[id]);
+        retiredBakes.push_back(std::move(bakeTasks[id]));
+    }
+}
+
+void cleanupBakedNoise() {
+    for (int i = 0; i < MATERIAL_COUNT; i++) {
+        cancelMaterialBake((MaterialId)i);
+    }
+    for (std::unique_ptr<BakeTask>& task : retiredBakes) {
+        waitForGroup(bakeJobs, task->group);
+    }
+    retiredBakes.clear();
+    waitForGroup(bakeJobs, cacheWrites);
+    stopJobSystem(bakeJobs);
+    deleteUploadRing(bakeUploads);
+
+    for (int i = 0; i < MATERIAL_COUNT; i++) {
+        deleteShader(bakedShaders[i]);
+        deleteVolume(bakedVolumes[i]);
+    }
+}
+
+// Starts the variants for the initial parameters straight away, so they are
+// usually ready by the first frame
+void setupShaderVariants() {
+    for (int i = 0; i < MATERIAL_COUNT; i++) {
+        std::string vertexPath = std::string("../shaders/vertex_") + materialShaderNames[i] + ".glsl";
+        std::string fragmentPath = std::string("../shaders/fragment_") + materialShaderNames[i] + ".glsl";
+        initShaderVariants(materialVariants[i], vertexPath.c_str(), fragmentPath.c_str(), MATERIAL_BINDING_BASE + i,
+                           MATERIAL_VARIANT_CAPACITY);
+        analyticShader((MaterialId)i);
+        // Instances carry their material, so these need no Material block;
+        // only built once the gallery asks for them
+        initShaderVariants(instancedVariants[i], vertexPath.c_str(), fragmentPath.c_str(), -1, 1);
+    }
+}
+
+void cleanupShaderVariants() {
+    for (int i = 0; i < MATERIAL_COUNT; i++) {
+        deleteShaderVariants(materialVariants[i]);
+        deleteShaderVariants(instancedVariants[i]);
+    }
+}
+
+// --variant-benchmark: Room 2's sphere filling the view, shaded either by the
+// generic program looping over the octaves uniform or by the variant with
+// the count compiled in
+void drawVariantBenchmarkFrame(unsigned int frameUBO, int octaves, bool specialized) {
+    if (room2Params.sphere2Octaves != octaves) {
+        room2Params.sphere2Octaves = octaves;
+        uploadMaterial(MATERIAL_SPHERE2);
+    }
+    specializedShaders = specialized;
+    while (specialized && !findShaderVariant(materialVariants[MATERIAL_SPHERE2], materialDefines(MATERIAL_SPHERE2))) {
+        waitForShaders();
+    }
+    const ShaderProgram& shader = analyticShader(MATERIAL_SPHERE2);
+
+    const SceneObject* sphere = std::find_if(std::begin(sceneObjects), std::end(sceneObjects),
+                                             [](const SceneObject& object) { return object.material == MATERIAL_SPHERE2; });
+    glm::vec3 eye = sphere->position + glm::vec3(0.0f, 0.0f, 1.8f);
+    glm::mat4 view = glm::lookAt(eye, sphere->position, glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1280.0f / 720.0f, 0.1f, 100.0f);
+    updateFrameData(frameUBO, view, projection, eye);
+
+    glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    const MeshRange& mesh = objectMesh(sphere->mesh);
+    glUseProgram(shader.id);
+    const Transform& transform = objectTransforms[sphere - sceneObjects];
+    glUniformMatrix4fv(shader.uniforms[UNIFORM_MODEL], 1, GL_FALSE, glm::value_ptr(transform.model));
+    glUniformMatrix3fv(shader.uniforms[UNIFORM_NORMAL_MATRIX], 1, GL_FALSE, glm::value_ptr(transform.normalMatrix));
+    glBindVertexArray(sceneGeometry.vao);
+    glDrawElementsBaseVertex(GL_TRIANGLES, mesh.count, sceneGeometry.indexType,
+                             (void*)(mesh.firstIndex * indexTypeSize(sceneGeometry.indexType)), mesh.baseVertex);
+}
+
+// --gallery-benchmark: the gallery at the given size, seen from Room 2's
+// doorway, with every program it needs built before the frame is timed
+void setGalleryBenchmarkFrame(int objects, bool instanced) {
+    galleryEnabled = true;
+    galleryInstanced = instanced;
+    if (galleryObjects != objects) {
+        galleryObjects = std::min(objects, GALLERY_MAX_OBJECTS);
+        galleryStale = true;
+    }
+    cameraPos = glm::vec3(10.2f, -1.0f, 0.0f);
+    cameraFront = glm::vec3(1.0f, 0.0f, 0.0f);
+    for (MaterialId id : galleryMaterials) {
+        while (instanced && !instancedShader(id)) {
+            waitForShaders();
+        }
+    }
+    waitForShader(instancedDepthShader);
+}
 
-    // Room 3 objects 
-    renderCube(cubeVAO, 3, view, projection, cameraPos, 
-              glm::vec3(32.0f, -3.0f, 2.5f),    
-              glm::vec3(2.5f));
+// --vertex-format-benchmark: the instanced gallery with the arena in either
+// layout. Spheres stay at the default level of detail: denser galleries pack
+// smaller spheres, which would otherwise drop to coarser levels and draw
+// fewer triangles than sparser ones.
+void setVertexFormatBenchmarkFrame(int objects, bool compact) {
+    setGalleryBenchmarkFrame(objects, true);
+    sphereLod = false;
+    if (compact != compactVertices) {
+        compactVertices = compact;
+        setVertexFormat(compact);
+    }
+}
 
-    renderSphere(sphereVAO, 3, view, projection, cameraPos, sphereIndices, 
-                glm::vec3(32.0f, -3.0f, -2.5f), 
-                glm::vec3(1.75f));
+#ifndef ROOMS_HEADLESS
+// Running bakes with their progress; cancelling one also switches the
+// material back to analytic noise, or it would simply be restarted
+void renderBakeProgress() {
+    bool baking = false;
+    for (int i = 0; i < MATERIAL_COUNT; i++) {
+        if (!bakeTasks[i]) continue;
+        if (!baking) {
+            ImGui::Separator();
+            ImGui::Text("Baking on %d threads", (int)bakeJobs.workers.size());
+            baking = true;
+        }
+        ImGui::PushID(i);
+        ImGui::ProgressBar(bakeProgress(*bakeTasks[i]), ImVec2(-70.0f, 0.0f), materialShaderNames[i]);
+        ImGui::SameLine();
+        if (ImGui::Button("Cancel")) {
+            cancelMaterialBake((MaterialId)i);
+            materialBaked[i] = false;
+        }
+        ImGui::PopID();
+    }
 }
 
+// Widgets return true on the frame their value changes; that marks the
+// material for re-upload in updateMaterials.
 void renderNoiseControls() {
 
     ImGui::Begin("Noise Controls");
     
     if (ImGui::CollapsingHeader("Room 1")) {
         if (ImGui::CollapsingHeader("Cube Parameters (Perlin Noise with Octaves)")) {
-            ImGui::SliderFloat("Cube Noise Scale", &room1Params.cubeNoiseScale, 0.1f, 5.0f);
-            ImGui::SliderFloat("Cube Noise Amplitude", &room1Params.cubeNoiseAmplitude, 0.0f, 1.0f);
-            ImGui::ColorEdit3("Cube Color", room1Params.cubeBaseColor);
+            materialDirty[MATERIAL_CUBE1] |= ImGui::SliderFloat("Cube Noise Scale", &room1Params.cubeNoiseScale, 0.1f, 5.0f);
+            materialDirty[MATERIAL_CUBE1] |= ImGui::SliderFloat("Cube Noise Amplitude", &room1Params.cubeNoiseAmplitude, 0.0f, 1.0f);
+            materialDirty[MATERIAL_CUBE1] |= ImGui::ColorEdit3("Cube Color", room1Params.cubeBaseColor);
+            ImGui::Checkbox("Cube Baked Noise", &materialBaked[MATERIAL_CUBE1]);
         }
         
         if (ImGui::CollapsingHeader("Sphere Parameters (simple Perlin Noise)")) {
-            ImGui::SliderFloat("Sphere Noise Scale", &room1Params.sphereNoiseScale, 0.1f, 5.0f);
-            ImGui::SliderFloat("Sphere Noise Offset", &room1Params.sphereNoiseOffset, 0.0f, 1.0f);
-            ImGui::SliderFloat("Sphere Noise Intensity", &room1Params.sphereNoiseIntensity, 0.0f, 1.0f);
-            ImGui::ColorEdit3("Sphere Color", room1Params.sphereBaseColor);
+            materialDirty[MATERIAL_SPHERE1] |= ImGui::SliderFloat("Sphere Noise Scale", &room1Params.sphereNoiseScale, 0.1f, 5.0f);
+            materialDirty[MATERIAL_SPHERE1] |= ImGui::SliderFloat("Sphere Noise Offset", &room1Params.sphereNoiseOffset, 0.0f, 1.0f);
+            materialDirty[MATERIAL_SPHERE1] |= ImGui::SliderFloat("Sphere Noise Intensity", &room1Params.sphereNoiseIntensity, 0.0f, 1.0f);
+            materialDirty[MATERIAL_SPHERE1] |= ImGui::ColorEdit3("Sphere Color", room1Params.sphereBaseColor);
+            ImGui::Checkbox("Sphere Baked Noise", &materialBaked[MATERIAL_SPHERE1]);
         }
         
         if (ImGui::CollapsingHeader("Pyramid Parameters (Perlin Noise with Turbulence)")) {
-            ImGui::SliderFloat("Pyramid Turbulence", &room1Params.pyramidNoiseTurbulence, 0.1f, 10.0f);
-            ImGui::SliderFloat("Pyramid Glow", &room1Params.pyramidNoiseGlow, 0.0f, 1.0f);
-            ImGui::SliderFloat("Pyramid Color Mix", &room1Params.pyramidColorMix, 0.0f, 1.0f);
-            ImGui::ColorEdit3("Pyramid Color 1", room1Params.pyramidBaseColor1);
-            ImGui::ColorEdit3("Pyramid Color 2", room1Params.pyramidBaseColor2);
+            materialDirty[MATERIAL_PYRAMID1] |= ImGui::SliderFloat("Pyramid Turbulence", &room1Params.pyramidNoiseTurbulence, 0.1f, 10.0f);
+            materialDirty[MATERIAL_PYRAMID1] |= ImGui::SliderFloat("Pyramid Glow", &room1Params.pyramidNoiseGlow, 0.0f, 1.0f);
+            materialDirty[MATERIAL_PYRAMID1] |= ImGui::SliderFloat("Pyramid Color Mix", &room1Params.pyramidColorMix, 0.0f, 1.0f);
+            materialDirty[MATERIAL_PYRAMID1] |= ImGui::ColorEdit3("Pyramid Color 1", room1Params.pyramidBaseColor1);
+            materialDirty[MATERIAL_PYRAMID1] |= ImGui::ColorEdit3("Pyramid Color 2", room1Params.pyramidBaseColor2);
+            ImGui::Checkbox("Pyramid Baked Noise", &materialBaked[MATERIAL_PYRAMID1]);
         }
     }
 
     if (ImGui::CollapsingHeader("Room 2")) {
         if (ImGui::CollapsingHeader("Cube Parameters (Simplex Noise)")) {
-            ImGui::SliderFloat("Cube Noise Scale", &room2Params.cube2NoiseScale, 0.1f, 5.0f);
-            ImGui::SliderFloat("Cube Noise Intensity", &room2Params.cube2NoiseIntensity, 0.0f, 1.0f);
-            ImGui::ColorEdit3("Cube Color", room2Params.cube2BaseColor);
+            materialDirty[MATERIAL_CUBE2] |= ImGui::SliderFloat("Cube Noise Scale", &room2Params.cube2NoiseScale, 0.1f, 5.0f);
+            materialDirty[MATERIAL_CUBE2] |= ImGui::SliderFloat("Cube Noise Intensity", &room2Params.cube2NoiseIntensity, 0.0f, 1.0f);
+            materialDirty[MATERIAL_CUBE2] |= ImGui::ColorEdit3("Cube Color", room2Params.cube2BaseColor);
+            ImGui::Checkbox("Cube Baked Noise", &materialBaked[MATERIAL_CUBE2]);
         }
 
         if (ImGui::CollapsingHeader("Sphere Parameters (Multifractal Noise)")) {
-            ImGui::SliderFloat("Sphere Noise Scale", &room2Params.sphere2NoiseScale, 0.1f, 5.0f);
-            ImGui::SliderFloat("Sphere Noise Intensity", &room2Params.sphere2NoiseIntensity, 0.0f, 1.0f);
-            ImGui::SliderFloat("Sphere Lacunarity", &room2Params.sphere2Lacunarity, 1.0f, 4.0f);
-            ImGui::SliderInt("Sphere Octaves", &room2Params.sphere2Octaves, 1, 8);
-            ImGui::ColorEdit3("Sphere Color", room2Params.sphere2BaseColor);
+            materialDirty[MATERIAL_SPHERE2] |= ImGui::SliderFloat("Sphere Noise Scale", &room2Params.sphere2NoiseScale, 0.1f, 5.0f);
+            materialDirty[MATERIAL_SPHERE2] |= ImGui::SliderFloat("Sphere Noise Intensity", &room2Params.sphere2NoiseIntensity, 0.0f, 1.0f);
+            materialDirty[MATERIAL_SPHERE2] |= ImGui::SliderFloat("Sphere Lacunarity", &room2Params.sphere2Lacunarity, 1.0f, 4.0f);
+            materialDirty[MATERIAL_SPHERE2] |= ImGui::SliderInt("Sphere Octaves", &room2Params.sphere2Octaves, 1, 8);
+            materialDirty[MATERIAL_SPHERE2] |= ImGui::ColorEdit3("Sphere Color", room2Params.sphere2BaseColor);
+            ImGui::Checkbox("Sphere Baked Noise", &materialBaked[MATERIAL_SPHERE2]);
         }
 
         if (ImGui::CollapsingHeader("Pyramid Parameters (Cellular Noise)")) {
-            ImGui::SliderFloat("Pyramid Noise Scale", &room2Params.pyramid2NoiseScale, 1.0f, 10.0f);
-            ImGui::SliderFloat("Pyramid Noise Intensity", &room2Params.pyramid2NoiseIntensity, 0.0f, 1.0f);
-            ImGui::SliderFloat("Pyramid Edge Threshold", &room2Params.pyramid2EdgeThreshold, 0.01f, 0.2f);
-            ImGui::SliderFloat("Pyramid Glow Strength", &room2Params.pyramid2GlowStrength, 0.0f, 1.0f);
-            ImGui::ColorEdit3("Pyramid Color 1", room2Params.pyramid2BaseColor1);
-            ImGui::ColorEdit3("Pyramid Color 2", room2Params.pyramid2BaseColor2);
+            materialDirty[MATERIAL_PYRAMID2] |= ImGui::SliderFloat("Pyramid Noise Scale", &room2Params.pyramid2NoiseScale, 1.0f, 10.0f);
+            materialDirty[MATERIAL_PYRAMID2] |= ImGui::SliderFloat("Pyramid Noise Intensity", &room2Params.pyramid2NoiseIntensity, 0.0f, 1.0f);
+            materialDirty[MATERIAL_PYRAMID2] |= ImGui::SliderFloat("Pyramid Edge Threshold", &room2Params.pyramid2EdgeThreshold, 0.01f, 0.2f);
+            materialDirty[MATERIAL_PYRAMID2] |= ImGui::SliderFloat("Pyramid Glow Strength", &room2Params.pyramid2GlowStrength, 0.0f, 1.0f);
+            materialDirty[MATERIAL_PYRAMID2] |= ImGui::ColorEdit3("Pyramid Color 1", room2Params.pyramid2BaseColor1);
+            materialDirty[MATERIAL_PYRAMID2] |= ImGui::ColorEdit3("Pyramid Color 2", room2Params.pyramid2BaseColor2);
+            ImGui::Checkbox("Pyramid Baked Noise", &materialBaked[MATERIAL_PYRAMID2]);
         }
     }
 
     if (ImGui::CollapsingHeader("Room 3")) {
         if (ImGui::CollapsingHeader("Cube Parameters (Perlin Noise on Transparency)")) {
-            ImGui::SliderFloat("Cube Noise Scale", &room3Params.cube3NoiseScale, 0.1f, 5.0f);
-            ImGui::SliderFloat("Cube Noise Intensity", &room3Params.cube3NoiseIntensity, 0.0f, 1.0f);
-            ImGui::ColorEdit3("Cube Color", room3Params.cube3BaseColor);
-            ImGui::SliderFloat("Cube Min Alpha", &room3Params.cube3MinAlpha, 0.0f, 1.0f);
-            ImGui::SliderFloat("Cube Max Alpha", &room3Params.cube3MaxAlpha, 0.0f, 1.0f);
+            materialDirty[MATERIAL_CUBE3] |= ImGui::SliderFloat("Cube Noise Scale", &room3Params.cube3NoiseScale, 0.1f, 5.0f);
+            materialDirty[MATERIAL_CUBE3] |= ImGui::SliderFloat("Cube Noise Intensity", &room3Params.cube3NoiseIntensity, 0.0f, 1.0f);
+            materialDirty[MATERIAL_CUBE3] |= ImGui::ColorEdit3("Cube Color", room3Params.cube3BaseColor);
+            materialDirty[MATERIAL_CUBE3] |= ImGui::SliderFloat("Cube Min Alpha", &room3Params.cube3MinAlpha, 0.0f, 1.0f);
+            materialDirty[MATERIAL_CUBE3] |= ImGui::SliderFloat("Cube Max Alpha", &room3Params.cube3MaxAlpha, 0.0f, 1.0f);
+            ImGui::Checkbox("Cube Baked Noise", &materialBaked[MATERIAL_CUBE3]);
         }
 
         if (ImGui::CollapsingHeader("Sphere Parameters (Perlin Noise on Normal Mapping)")) {
-            ImGui::SliderFloat("Sphere Noise Scale", &room3Params.sphere3NoiseScale, 0.1f, 10.0f);
-            ImGui::SliderFloat("Sphere Normal Strength", &room3Params.sphere3NormalStrength, 0.0f, 2.0f);
-            ImGui::ColorEdit3("Sphere Color", room3Params.sphere3BaseColor);
-            ImGui::SliderFloat("Sphere Glossiness", &room3Params.sphere3Glossiness, 1.0f, 128.0f);
+            materialDirty[MATERIAL_SPHERE3] |= ImGui::SliderFloat("Sphere Noise Scale", &room3Params.sphere3NoiseScale, 0.1f, 10.0f);
+            materialDirty[MATERIAL_SPHERE3] |= ImGui::SliderFloat("Sphere Normal Strength", &room3Params.sphere3NormalStrength, 0.0f, 2.0f);
+            materialDirty[MATERIAL_SPHERE3] |= ImGui::ColorEdit3("Sphere Color", room3Params.sphere3BaseColor);
+            materialDirty[MATERIAL_SPHERE3] |= ImGui::SliderFloat("Sphere Glossiness", &room3Params.sphere3Glossiness, 1.0f, 128.0f);
+            ImGui::Checkbox("Sphere Baked Noise", &materialBaked[MATERIAL_SPHERE3]);
+        }
+    }
+    renderBakeProgress();
+    ImGui::End();
+}
+
+void renderFrameStats() {
+    ImGui::Begin("Frame Stats");
+    ImGui::Text("%.2f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+    ImGui::Checkbox("Portal culling", &portalCulling);
+    ImGui::Checkbox("Frustum culling", &frustumCulling);
+    ImGui::Checkbox("Depth pre-pass", &depthPrepass);
+    ImGui::Checkbox("Specialised shaders", &specializedShaders);
+    ImGui::Checkbox("Sphere LOD", &sphereLod);
+    if (ImGui::Checkbox("Compact vertices", &compactVertices)) {
+        setVertexFormat(compactVertices);
+    }
+    ImGui::Checkbox("Gallery", &galleryEnabled);
+    if (galleryEnabled) {
+        ImGui::Checkbox("Instanced", &galleryInstanced);
+        if (ImGui::SliderInt("Objects", &galleryObjects, 1, GALLERY_MAX_OBJECTS)) {
+            galleryStale = true;
         }
     }
+    forEachCounter(frameStats, [](const char* name, unsigned int value) {
+        ImGui::Text("%s: %u", name, value);
+    });
     ImGui::End();
 }
+#endif
+
+int main(int argc, char** argv) {
+    BenchmarkOptions benchmark;
+    if (!parseBenchmarkArgs(argc, argv, benchmark)) {
+        return -1;
+    }
+    if (benchmark.noiseBenchmark) {
+        return runNoiseBenchmark(benchmark);
+    }
+    if (benchmark.bakeBenchmark) {
+        return runBakeBenchmark(benchmark);
+    }
+    setShaderFilesFromDisk(benchmark.shaderFiles);
 
-int main() {
+#ifdef ROOMS_HEADLESS
+    // The headless target has no window, it only runs the benchmark
+    benchmark.enabled = true;
+    if (!createHeadlessContext(BENCHMARK_WIDTH, BENCHMARK_HEIGHT)) {
+        std::cout << "Failed to create headless OpenGL context" << std::endl;
+        return -1;
+    }
+
+    // Initialize GLAD
+    if (!gladLoadGLLoader((GLADloadproc)headlessGetProcAddress)) {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        return -1;
+    }
+    loadGLExtensions((GLADloadproc)headlessGetProcAddress);
+#else
     // Initialize GLFW
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (benchmark.enabled) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    }
 
     GLFWwindow* window = glfwCreateWindow(1280, 720, "Room", NULL, NULL);
     if (window == NULL) {
@@ -1207,95 +2026,228 @@ int main() {
         std::cout << "Failed to initialize GLAD" << std::endl;
         return -1;
     }
+    loadGLExtensions((GLADloadproc)glfwGetProcAddress);
 
     // Configure window and callbacks
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-    glfwSetCursorPosCallback(window, mouse_callback);
+    if (!benchmark.enabled) {
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+        glfwSetCursorPosCallback(window, mouse_callback);
+    }
+#endif
     glEnable(GL_DEPTH_TEST);
 
     // Enable blending for transparency
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    unsigned int roomVAO, roomVBO, roomEBO;
-    unsigned int roomShaders[6];
-    setupRooms(roomVAO, roomVBO, roomEBO, roomShaders);
-
-    unsigned int sphereVAO, sphereVBO, sphereEBO;
-    std::vector<unsigned int> sphereIndices;
-    setupSphere(sphereVAO, sphereVBO, sphereEBO, sphereIndices);
-
-    unsigned int pyramidVAO, pyramidVBO, pyramidEBO;
-    setupPyramid(pyramidVAO, pyramidVBO, pyramidEBO);    
-
-    unsigned int cubeVAO, cubeVBO, cubeEBO;
-    setupCube(cubeVAO, cubeVBO, cubeEBO);
-
-    unsigned int corridorVAO, corridorVBO, corridorEBO, corridorShader;
-    setupCorridors(corridorVAO, corridorVBO, corridorEBO, corridorShader);
+    // Startup is dominated by building programs; timed to compare a cold
+    // start with one served from the program binary cache
+    std::chrono::steady_clock::time_point startupBegin = std::chrono::steady_clock::now();
+
+    unsigned int frameUBO;
+    setupFrameData(frameUBO);
+    setupMaterials();
+
+    ShaderProgram roomShaders[6];
+    setupRooms(roomShaders);
+    setupSphere();
+    setupPyramid();
+    setupCube();
+
+    ShaderProgram corridorShader;
+    setupCorridors(corridorShader);
+
+    ShaderProgram doorShader;
+    setupDoorFrames(doorShader);
+    std::vector<int> blendedMeshes;
+    for (const SceneObject& object : sceneObjects) {
+        if (object.pass != PASS_TRANSPARENT) continue;
+        if (object.mesh == MESH_SPHERE) {
+            blendedMeshes.insert(blendedMeshes.end(), std::begin(sphereLods), std::end(sphereLods));
+        } else {
+            blendedMeshes.push_back(objectMeshes[object.mesh]);
+        }
+    }
+    optimizeGeometryArena(sceneGeometry, blendedMeshes);
+    uploadGeometryArena(sceneGeometry);
+    setupObjectTransforms();
+    setupGallery();
+    setupPortals();
+    createShader(depthShader, "../shaders/vertex_depth.glsl", "../shaders/fragment_depth.glsl");
+    depthPrepass = benchmark.depthPrepass;
+    setupBakedNoise();
+    setupShaderVariants();
+    if (benchmark.shaderFiles) {
+        // Edited shaders are rebuilt and swapped in while the app runs
+        startShaderHotReload("../shaders");
+        setShaderReloadCallback([](const ShaderProgram& program) {
+            for (int i = 0; i < MATERIAL_COUNT; i++) {
+                if (&program == &bakedShaders[i] && bakedVolumes[i].key != 0) applyVolumeUniforms((MaterialId)i);
+            }
+        });
+    }
 
-    unsigned int doorVAO, doorVBO, doorEBO, doorShader;
-    setupDoorFrames(doorVAO, doorVBO, doorEBO, doorShader);
+    // The first frame only needs the programs it draws with; the baked-noise
+    // ones and the specialised variants keep building in the background
+    for (ShaderProgram& shader : roomShaders) {
+        waitForShader(shader);
+    }
+    waitForShader(corridorShader);
+    waitForShader(doorShader);
+    waitForShader(depthShader);
+    for (ShaderProgram* shader : materialShaders) {
+        waitForShader(*shader);
+    }
 
-    // Initialize ImGui
-    IMGUI_CHECKVERSION();
-    ImGui::CreateContext();
-    ImGuiIO& io = ImGui::GetIO(); (void)io;
-    ImGui::StyleColorsDark();
-    ImGui_ImplGlfw_InitForOpenGL(window, true);
-    ImGui_ImplOpenGL3_Init("#version 130");
+    double startupMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startupBegin).count();
+    std::cout << "Startup (" << (programCacheStats.compiled == 0 ? "warm" : "cold") << "): " << startupMs << " ms, "
+              << programCacheStats.compiled + programCacheStats.loaded << " programs, " << programCacheStats.loaded
+              << " from the binary cache, " << programCacheStats.compiled << " compiled";
+    if (programCacheStats.rejected > 0) {
+        std::cout << " (" << programCacheStats.rejected << " cached binaries rejected)";
+    }
+    std::cout << ", " << pollShaders() << " still building"
+              << (glExtensions.parallelShaderCompile ? " (parallel compile)" : "") << std::endl;
 
-    // Render loop
-    while (!glfwWindowShouldClose(window)) {
-        float currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
+    for (int i = 0; i < MATERIAL_COUNT; i++) {
+        materialBaked[i] = benchmark.bakedNoise;
+    }
+    // Measured frames should not depend on how fast the bakes land, or share
+    // the CPU with compiles still running
+    if (benchmark.enabled) {
+        waitForShaders();
+    }
+    if (benchmark.bakedNoise) {
+        finishBakedNoise();
+    }
 
-        processInput(window);
+    RenderQueue renderQueue;
+    auto renderScene = [&]() {
+        frameStats = FrameStats();
 
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        // Start ImGui frame
-        ImGui_ImplOpenGL3_NewFrame();
-        ImGui_ImplGlfw_NewFrame();
-        ImGui::NewFrame();
-
-        // Render GUI
-        renderNoiseControls();
-
-        // Render scene
         glm::mat4 view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
         glm::mat4 projection = glm::perspective(glm::radians(45.0f), 1280.0f / 720.0f, 0.1f, 100.0f);
 
-        // Render rooms, corridors, door frames, and objects
-        renderRooms(roomVAO, roomShaders, view, projection);
-        renderCorridors(corridorVAO, corridorShader, view, projection, cameraPos);
-        renderDoorFrames(doorVAO, doorShader, view, projection);
-        renderObjects(cubeVAO, sphereVAO, pyramidVAO, view, projection, cameraPos, sphereIndices);
-
-        // Render ImGui
-        ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        updateFrameData(frameUBO, view, projection, cameraPos);
+        updateMaterials();
+        reloadChangedShaders();
+        pollShaders();
+        updateBakedNoise();
+
+        // Only cells seen through the chain of doorways get submitted
+        if (portalCulling) {
+            computeVisibility(levelPortals, cameraPos, projection * view, 0.1f, visibility);
+        } else {
+            markAllVisible(levelPortals, visibility);
+        }
+        viewFrustum = extractFrustum(projection * view);
+        cameraProjection = projection;
+
+        // Queue rooms, corridors, door frames, and objects, then draw them
+        // sorted to minimise program and VAO changes
+        beginRenderQueue(renderQueue, view, 100.0f, sceneGeometry.indexType);
+        submitRooms(renderQueue, roomShaders);
+        submitCorridors(renderQueue, corridorShader);
+        submitDoorFrames(renderQueue, doorShader);
+        submitObjects(renderQueue);
+        submitGallery(renderQueue);
+        sortRenderQueue(renderQueue);
+        if (depthPrepass) {
+            executeDepthPrepass(renderQueue, depthShader, instancedDepthShader);
+        }
+        executeRenderQueue(renderQueue, depthPrepass);
+    };
 
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+    int exitCode = 0;
+    if (benchmark.variantBenchmark) {
+        exitCode = runVariantBenchmark(benchmark, [&](int octaves, bool specialized) {
+            drawVariantBenchmarkFrame(frameUBO, octaves, specialized);
+        });
+    } else if (benchmark.galleryBenchmark) {
+        exitCode = runGalleryBenchmark(benchmark, [&](int objects, bool instanced) {
+            setGalleryBenchmarkFrame(objects, instanced);
+            renderScene();
+        });
+    } else if (benchmark.vertexFormatBenchmark) {
+        exitCode = runVertexFormatBenchmark(benchmark, [&](int objects, bool compact) {
+            setVertexFormatBenchmarkFrame(objects, compact);
+            renderScene();
+        });
+    } else if (benchmark.enabled) {
+        exitCode = runBenchmark(benchmark, [&](const glm::vec3& position, const glm::vec3& front) {
+            cameraPos = position;
+            cameraFront = front;
+            renderScene();
+        });
     }
+#ifndef ROOMS_HEADLESS
+    else {
+        // Initialize ImGui
+        IMGUI_CHECKVERSION();
+        ImGui::CreateContext();
+        ImGuiIO& io = ImGui::GetIO(); (void)io;
+        ImGui::StyleColorsDark();
+        ImGui_ImplGlfw_InitForOpenGL(window, true);
+        ImGui_ImplOpenGL3_Init("#version 130");
+
+        // Render loop
+        while (!glfwWindowShouldClose(window)) {
+            float currentFrame = glfwGetTime();
+            deltaTime = currentFrame - lastFrame;
+            lastFrame = currentFrame;
+
+            processInput(window);
+
+            // Start ImGui frame
+            ImGui_ImplOpenGL3_NewFrame();
+            ImGui_ImplGlfw_NewFrame();
+            ImGui::NewFrame();
+
+            // Render GUI
+            renderNoiseControls();
+            renderFrameStats();
+
+            // Render scene
+            renderScene();
+
+            // Render ImGui
+            ImGui::Render();
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+            glfwSwapBuffers(window);
+            glfwPollEvents();
+        }
 
-    // Cleanup ImGui
-    ImGui_ImplOpenGL3_Shutdown();
-    ImGui_ImplGlfw_Shutdown();
-    ImGui::DestroyContext();
+        // Cleanup ImGui
+        ImGui_ImplOpenGL3_Shutdown();
+        ImGui_ImplGlfw_Shutdown();
+        ImGui::DestroyContext();
+    }
+#endif
 
     // Cleanup
-    cleanupDoorFrames(doorVAO, doorVBO, doorEBO, doorShader);
-    cleanupCorridors(corridorVAO, corridorVBO, corridorEBO, corridorShader);
-    cleanupPyramid(pyramidVAO, pyramidVBO, pyramidEBO);
-    cleanupSphere(sphereVAO, sphereVBO, sphereEBO);
-    cleanupCube(cubeVAO, cubeVBO, cubeEBO);
-    cleanupRooms(roomVAO, roomVBO, roomEBO, roomShaders);
+    cleanupDoorFrames(doorShader);
+    cleanupCorridors(corridorShader);
+    cleanupPyramid();
+    cleanupSphere();
+    cleanupCube();
+    cleanupRooms(roomShaders);
+    cleanupGallery();
+    destroyGeometryArena(sceneGeometry);
+    deleteShader(depthShader);
+    stopShaderHotReload();
+    cleanupShaderVariants();
+    cleanupBakedNoise();
+    cleanupMaterials();
+    cleanupFrameData(frameUBO);
     
+#ifdef ROOMS_HEADLESS
+    destroyHeadlessContext();
+#else
     glfwTerminate();
-    return 0;
+#endif
+    return exitCode;
 }
-
@@ -0,0 +1,640 @@
+#include "Shader.h"
+#include "FrameStats.h"
+#include "GLExtensions.h"
+#include "Hash.h"
+#include "ShaderPreprocessor.h"
+#include "ShaderWatcher.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+static const char* uniformNames[UNIFORM_COUNT] = {
+    "model",
+    "normalMatrix",
+    "bakedNoise",
+    "bakedMin",
+    "bakedInvSize",
+};
+
+#include "EmbeddedShaders.inl"
+
+static bool shaderFilesFromDisk = false;
+
+void setShaderFilesFromDisk(bool fromDisk) {
+    shaderFilesFromDisk = fromDisk;
+}
+
+// What follows the last "shaders/" in a path: the key of the embedded
+// tables, and how the hot reload watcher names files
+static const char* shaderName(const char* filePath) {
+    const char* name = filePath;
+    for (const char* found = std::strstr(filePath, "shaders/"); found; found = std::strstr(found + 1, "shaders/")) {
+        name = found + std::strlen("shaders/");
+    }
+    return name;
+}
+
+static std::string readEmbeddedShader(const char* filePath) {
+    const char* name = shaderName(filePath);
+
+    const EmbeddedShaderFile* begin = EMBEDDED_SHADER_FILES;
+    const EmbeddedShaderFile* end = begin + sizeof(EMBEDDED_SHADER_FILES) / sizeof(EMBEDDED_SHADER_FILES[0]);
+    const EmbeddedShaderFile* file = std::lower_bound(begin, end, name,
+        [](const EmbeddedShaderFile& entry, const char* key) { return std::strcmp(entry.name, key) < 0; });
+    if (file == end || std::strcmp(file->name, name) != 0) {
+        std::cout << "ERROR::SHADER::NOT_EMBEDDED: " << filePath << std::endl;
+        return std::string();
+    }
+
+    std::string shaderCode;
+    for (int i = 0; i < file->snippetCount; i++) {
+        shaderCode += EMBEDDED_SHADER_SNIPPETS[EMBEDDED_SHADER_FILE_SNIPPETS[file->firstSnippet + i]];
+    }
+    return shaderCode;
+}
+
+std::string readShaderFile(const char* filePath) {
+    if (!shaderFilesFromDisk) {
+        return readEmbeddedShader(filePath);
+    }
+
+    std::string shaderCode;
+    std::ifstream shaderFile;
+    
+    shaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+    try {
+        shaderFile.open(filePath);
+        std::stringstream shaderStream;
+        shaderStream << shaderFile.rdbuf();
+        shaderFile.close();
+        shaderCode = shaderStream.str();
+    }
+    catch (std::ifstream::failure& e) {
+        std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << filePath << std::endl;
+    }
+    
+    return shaderCode;
+}
+
+// Program binaries live in PROGRAM_CACHE_DIRECTORY as <key>.bin: this header,
+// then the driver's blob. The key hashes both sources and the driver's
+// vendor, renderer and version strings, so a driver update or an edited
+// shader simply misses. Variants and edited shaders keep adding entries, so
+// the directory is kept under PROGRAM_CACHE_MAX_BYTES by evicting the least
+// recently used ones, as the volume cache does.
+static const char* const PROGRAM_CACHE_DIRECTORY = "../cache/programs";
+static const uint32_t PROGRAM_CACHE_VERSION = 1;
+static const uint64_t PROGRAM_CACHE_MAX_BYTES = 16ull << 20;
+
+struct ProgramBinaryHeader {
+    char magic[4];          // "RPRG"
+    uint32_t version;
+    uint64_t key;
+    uint32_t format;
+    uint32_t length;
+};
+
+ProgramCacheStats programCacheStats;
+
+static uint64_t programKey(const std::string& vertexCode, const std::string& fragmentCode) {
+    uint64_t key = hashBytes(vertexCode.data(), vertexCode.size());
+    // Separator, so moving text from one stage to the other changes the key
+    key = hashBytes("", 1, key);
+    key = hashBytes(fragmentCode.data(), fragmentCode.size(), key);
+    const GLenum driverStrings[] = {GL_VENDOR, GL_RENDERER, GL_VERSION};
+    for (GLenum name : driverStrings) {
+        const char* value = (const char*)glGetString(name);
+        key = hashBytes(value, std::strlen(value) + 1, key);
+    }
+    return key;
+}
+
+static std::string programCachePath(uint64_t key) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+    return std::string(PROGRAM_CACHE_DIRECTORY) + "/" + name;
+}
+
+// Bytes in PROGRAM_CACHE_DIRECTORY, known once the first save has scanned it;
+// later saves add to it and only rescan when it goes over the limit
+static uint64_t programCacheBytes = 0;
+static bool programCacheScanned = false;
+
+static void removeProgramBinary(const std::string& path) {
+    std::error_code error;
+    uint64_t bytes = std::filesystem::file_size(path, error);
+    if (std::filesystem::remove(path, error) && programCacheScanned) {
+        programCacheBytes -= std::min(bytes, programCacheBytes);
+    }
+}
+
+static bool loadProgramBinary(ShaderProgram& program, uint64_t key) {
+    std::string path = programCachePath(key);
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    std::error_code error;
+    uint64_t fileBytes = std::filesystem::file_size(path, error);
+    ProgramBinaryHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    bool valid = !error && file
+              && std::memcmp(header.magic, "RPRG", 4) == 0
+              && header.version == PROGRAM_CACHE_VERSION
+              && header.key == key
+              && header.length > 0
+              && fileBytes == sizeof(header) + (uint64_t)header.length;
+    std::vector<char> binary;
+    if (valid) {
+        binary.resize(header.length);
+        valid = (bool)file.read(binary.data(), header.length);
+    }
+    file.close();
+    if (!valid) {
+        // Written by another version, or damaged: link again
+        removeProgramBinary(path);
+        return false;
+    }
+
+    // A hit makes the entry the most recently used one
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+
+    program.id = glCreateProgram();
+    glExtensions.programBinaryLoad(program.id, header.format, binary.data(), (GLsizei)header.length);
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program.id, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        // The driver may turn down binaries from another build; not an error,
+        // the entry is written again once the program links from source
+        glDeleteProgram(program.id);
+        program.id = 0;
+        programCacheStats.rejected++;
+        removeProgramBinary(path);
+        return false;
+    }
+    return true;
+}
+
+static void evictProgramBinaries() {
+    struct Entry {
+        std::filesystem::path path;
+        uint64_t bytes;
+        std::filesystem::file_time_type used;
+    };
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+
+    std::error_code error;
+    for (std::filesystem::directory_iterator it(PROGRAM_CACHE_DIRECTORY, error), end; !error && it != end;
+         it.increment(error)) {
+        if (it->path().extension() != ".bin") continue;
+        Entry entry;
+        entry.path = it->path();
+        entry.bytes = it->file_size(error);
+        entry.used = it->last_write_time(error);
+        if (error) {
+            error.clear();
+            continue;
+        }
+        entries.push_back(entry);
+        total += entry.bytes;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.used < b.used; });
+    for (const Entry& entry : entries) {
+        if (total <= PROGRAM_CACHE_MAX_BYTES) break;
+        std::filesystem::remove(entry.path, error);
+        total -= entry.bytes;
+    }
+    programCacheBytes = total;
+    programCacheScanned = true;
+}
+
+static void saveProgramBinary(const ShaderProgram& program, uint64_t key) {
+    GLint length = 0;
+    glGetProgramiv(program.id, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+
+    ProgramBinaryHeader header;
+    std::memcpy(header.magic, "RPRG", 4);
+    header.version = PROGRAM_CACHE_VERSION;
+    header.key = key;
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glExtensions.getProgramBinary(program.id, length, NULL, &format, binary.data());
+    header.format = format;
+    header.length = (uint32_t)length;
+
+    std::error_code error;
+    std::filesystem::create_directories(PROGRAM_CACHE_DIRECTORY, error);
+    // Through a temporary file and a rename, so a crash never leaves a
+    // partial entry behind
+    std::string path = programCachePath(key);
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), length);
+        if (!file) {
+            std::cout << "ERROR::SHADER::CANNOT_WRITE_PROGRAM_CACHE: " << temporary << std::endl;
+            return;
+        }
+    }
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return;
+    }
+
+    // A save only follows a miss, so the entry is new to the total
+    programCacheBytes += sizeof(header) + (uint64_t)length;
+    if (!programCacheScanned || programCacheBytes > PROGRAM_CACHE_MAX_BYTES) {
+        evictProgramBinaries();
+    }
+}
+
+static bool checkCompileErrors(unsigned int shader, const ShaderSource& source) {
+    GLint success = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (!success) {
+        char infoLog[1024];
+        glGetShaderInfoLog(shader, sizeof(infoLog), NULL, infoLog);
+        std::cout << "ERROR::SHADER::COMPILATION_FAILED: " << source.files[0] << "\n"
+                  << mapSourceNames(infoLog, source) << std::endl;
+    }
+    return success == GL_TRUE;
+}
+
+static bool checkLinkErrors(unsigned int program, const std::string& vertexPath, const std::string& fragmentPath) {
+    GLint success = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        char infoLog[1024];
+        glGetProgramInfoLog(program, sizeof(infoLog), NULL, infoLog);
+        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED: " << vertexPath << " + " << fragmentPath << "\n"
+                  << infoLog << std::endl;
+    }
+    return success == GL_TRUE;
+}
+
+// A program between createShader and ready. Both stages compile first; the
+// link is only submitted once they are done, so the two times can be told
+// apart and compile errors are reported before the link fails on them.
+struct ShaderBuild {
+    ShaderProgram* program;
+    // Set for a hot reload: the build goes into replacement, which is swapped
+    // into reloadTarget if it links
+    ShaderProgram* reloadTarget;
+    std::unique_ptr<ShaderProgram> replacement;
+    std::chrono::steady_clock::time_point editTime;
+    ShaderSource vertexSource;
+    ShaderSource fragmentSource;
+    int materialBinding;
+    uint64_t key;
+    unsigned int vertexShader;
+    unsigned int fragmentShader;
+    bool linking;
+    std::chrono::steady_clock::time_point compileStart;
+    std::chrono::steady_clock::time_point linkStart;
+    double compileMs;
+};
+
+static std::vector<ShaderBuild> pendingBuilds;
+
+// Every program created and not deleted yet, with what it is built from,
+// so that hot reload can tell which ones an edited file goes into
+struct ShaderRecord {
+    ShaderProgram* program;
+    std::string vertexPath;
+    std::string fragmentPath;
+    int materialBinding;
+    ShaderDefines defines;
+    std::vector<std::string> files;     // shaderName of both stages and everything they include
+};
+
+static std::vector<ShaderRecord> shaderRecords;
+static ShaderWatcher shaderWatcher;
+static bool hotReload = false;
+static std::function<void(const ShaderProgram&)> reloadCallback;
+
+// Without the extension the status queries themselves wait for the driver,
+// so everything reads as complete and pollShaders() blocks instead
+static bool shaderComplete(unsigned int shader) {
+    if (!glExtensions.parallelShaderCompile) return true;
+    GLint complete = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPLETION_STATUS_KHR, &complete);
+    return complete == GL_TRUE;
+}
+
+static bool programComplete(unsigned int program) {
+    if (!glExtensions.parallelShaderCompile) return true;
+    GLint complete = GL_FALSE;
+    glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &complete);
+    return complete == GL_TRUE;
+}
+
+static void finishProgram(ShaderProgram& program, int materialBinding) {
+    resolveUniforms(program);
+    if (materialBinding >= 0) {
+        bindUniformBlock(program, "Material", materialBinding);
+    }
+    program.materialBinding = materialBinding;
+    program.ready = true;
+}
+
+static double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// The old program stays in use when the new one failed to build
+static void finishReload(ShaderBuild& build, bool linked) {
+    const std::string& vertexPath = build.vertexSource.files[0];
+    const std::string& fragmentPath = build.fragmentSource.files[0];
+    if (!linked) {
+        glDeleteProgram(build.program->id);
+        std::cout << "Shader " << vertexPath << " + " << fragmentPath << ": reload failed, keeping the previous program"
+                  << std::endl;
+        return;
+    }
+
+    finishProgram(*build.program, build.materialBinding);
+    glDeleteProgram(build.reloadTarget->id);
+    *build.reloadTarget = *build.program;
+    std::cout << "Shader " << vertexPath << " + " << fragmentPath << ": reloaded " << millisecondsSince(build.editTime)
+              << " ms after the edit" << std::endl;
+    if (reloadCallback) {
+        reloadCallback(*build.reloadTarget);
+    }
+}
+
+// Returns true once the build is finished and its program ready
+static bool advanceBuild(ShaderBuild& build) {
+    if (!build.linking) {
+        if (!shaderComplete(build.vertexShader) || !shaderComplete(build.fragmentShader)) return false;
+        build.compileMs = millisecondsSince(build.compileStart);
+        checkCompileErrors(build.vertexShader, build.vertexSource);
+        checkCompileErrors(build.fragmentShader, build.fragmentSource);
+
+        unsigned int program = build.program->id;
+        glAttachShader(program, build.vertexShader);
+        glAttachShader(program, build.fragmentShader);
+        if (glExtensions.programBinary) {
+            glExtensions.programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+        glLinkProgram(program);
+        build.linking = true;
+        build.linkStart = std::chrono::steady_clock::now();
+    }
+    if (!programComplete(build.program->id)) return false;
+    double linkMs = millisecondsSince(build.linkStart);
+
+    glDeleteShader(build.vertexShader);
+    glDeleteShader(build.fragmentShader);
+    const std::string& vertexPath = build.vertexSource.files[0];
+    const std::string& fragmentPath = build.fragmentSource.files[0];
+    bool linked = checkLinkErrors(build.program->id, vertexPath, fragmentPath);
+    if (linked && glExtensions.programBinary) {
+        saveProgramBinary(*build.program, build.key);
+    }
+    if (build.reloadTarget) {
+        std::cout << "Shader " << vertexPath << " + " << fragmentPath << ": compiled in " << build.compileMs
+                  << " ms, linked in " << linkMs << " ms" << std::endl;
+        finishReload(build, linked);
+        return true;
+    }
+    finishProgram(*build.program, build.materialBinding);
+
+    std::cout << "Shader " << vertexPath << " + " << fragmentPath << ": compiled in " << build.compileMs
+              << " ms, linked in " << linkMs << " ms" << std::endl;
+    return true;
+}
+
+static unsigned int submitCompile(GLenum type, const std::string& source) {
+    const char* text = source.c_str();
+    unsigned int shader = glCreateShader(type);
+    glShaderSource(shader, 1, &text, NULL);
+    glCompileShader(shader);
+    return shader;
+}
+
+static void addSourceFiles(const ShaderSource& source, std::vector<std::string>& files) {
+    // Includes are relative to the top-level shader's directory
+    std::string path = source.files[0];
+    std::string directory = path.substr(0, path.find_last_of("/\\") + 1);
+    for (size_t i = 0; i < source.files.size(); i++) {
+        std::string name = shaderName((i == 0 ? path : directory + source.files[i]).c_str());
+        if (std::find(files.begin(), files.end(), name) == files.end()) files.push_back(name);
+    }
+}
+
+// Preprocesses and submits a build for record's program, into the program
+// itself or, with reloadTarget set, into a replacement for it
+static void startBuild(ShaderRecord& record, ShaderProgram* reloadTarget,
+                       std::chrono::steady_clock::time_point editTime) {
+    ShaderSource vertexSource, fragmentSource;
+    preprocessShader(record.vertexPath, vertexSource, record.defines);
+    preprocessShader(record.fragmentPath, fragmentSource, record.defines);
+    record.files.clear();
+    addSourceFiles(vertexSource, record.files);
+    addSourceFiles(fragmentSource, record.files);
+
+    ShaderBuild build;
+    build.reloadTarget = reloadTarget;
+    build.editTime = editTime;
+    if (reloadTarget) build.replacement.reset(new ShaderProgram());
+    ShaderProgram& program = reloadTarget ? *build.replacement : *record.program;
+    int materialBinding = record.materialBinding;
+
+    program = ShaderProgram();
+    uint64_t key = 0;
+    if (glExtensions.programBinary) {
+        key = programKey(vertexSource.code, fragmentSource.code);
+        if (loadProgramBinary(program, key)) {
+            if (reloadTarget) {
+                build.program = &program;
+                build.materialBinding = materialBinding;
+                build.vertexSource = std::move(vertexSource);
+                build.fragmentSource = std::move(fragmentSource);
+                finishReload(build, true);
+                return;
+            }
+            programCacheStats.loaded++;
+            finishProgram(program, materialBinding);
+            return;
+        }
+    }
+
+    build.program = &program;
+    build.materialBinding = materialBinding;
+    build.key = key;
+    build.compileStart = std::chrono::steady_clock::now();
+    build.vertexShader = submitCompile(GL_VERTEX_SHADER, vertexSource.code);
+    build.fragmentShader = submitCompile(GL_FRAGMENT_SHADER, fragmentSource.code);
+    build.linking = false;
+    build.compileMs = 0.0;
+    build.vertexSource = std::move(vertexSource);
+    build.fragmentSource = std::move(fragmentSource);
+    program.id = glCreateProgram();
+    pendingBuilds.push_back(std::move(build));
+    if (!reloadTarget) programCacheStats.compiled++;
+}
+
+void createShader(ShaderProgram& program, const char* vertexPath, const char* fragmentPath, int materialBinding,
+                  const ShaderDefines& defines) {
+    ShaderRecord record;
+    record.program = &program;
+    record.vertexPath = vertexPath;
+    record.fragmentPath = fragmentPath;
+    record.materialBinding = materialBinding;
+    record.defines = defines;
+    shaderRecords.push_back(record);
+    startBuild(shaderRecords.back(), NULL, std::chrono::steady_clock::now());
+}
+
+int pollShaders() {
+    pendingBuilds.erase(std::remove_if(pendingBuilds.begin(), pendingBuilds.end(), advanceBuild), pendingBuilds.end());
+    return (int)pendingBuilds.size();
+}
+
+void waitForShader(const ShaderProgram& program) {
+    while (!program.ready && pollShaders() > 0) {
+        std::this_thread::yield();
+    }
+}
+
+void waitForShaders() {
+    while (pollShaders() > 0) {
+        std::this_thread::yield();
+    }
+}
+
+void resolveUniforms(ShaderProgram& program) {
+    // The only place that looks uniforms up by name; counted so the frame
+    // stats show when a string lookup sneaks back into the render loop.
+    for (int slot = 0; slot < UNIFORM_COUNT; slot++) {
+        program.uniforms[slot] = glGetUniformLocation(program.id, uniformNames[slot]);
+        frameStats.uniformLookups++;
+    }
+
+    bindUniformBlock(program, "FrameData", FRAME_DATA_BINDING);
+}
+
+void bindUniformBlock(const ShaderProgram& program, const char* blockName, unsigned int binding) {
+    // GLSL 330 has no binding layout qualifier, so blocks are bound here
+    unsigned int blockIndex = glGetUniformBlockIndex(program.id, blockName);
+    frameStats.uniformLookups++;
+    if (blockIndex != GL_INVALID_INDEX) {
+        glUniformBlockBinding(program.id, blockIndex, binding);
+    }
+}
+
+// Drops the builds going into program or replacing it, reloads included
+static void cancelBuilds(ShaderProgram& program) {
+    for (size_t i = pendingBuilds.size(); i-- > 0;) {
+        ShaderBuild& build = pendingBuilds[i];
+        if (build.program != &program && build.reloadTarget != &program) continue;
+        glDeleteShader(build.vertexShader);
+        glDeleteShader(build.fragmentShader);
+        if (build.reloadTarget) glDeleteProgram(build.program->id);
+        pendingBuilds.erase(pendingBuilds.begin() + i);
+    }
+}
+
+void deleteShader(ShaderProgram& program) {
+    cancelBuilds(program);
+    shaderRecords.erase(std::remove_if(shaderRecords.begin(), shaderRecords.end(),
+                                       [&](const ShaderRecord& record) { return record.program == &program; }),
+                        shaderRecords.end());
+    glDeleteProgram(program.id);
+    program.ready = false;
+    program.id = 0;
+}
+
+bool startShaderHotReload(const char* shaderDirectory) {
+    hotReload = openShaderWatcher(shaderWatcher, shaderDirectory);
+    if (hotReload) {
+        std::cout << "Watching " << shaderDirectory << " for shader edits" << std::endl;
+    }
+    return hotReload;
+}
+
+void reloadChangedShaders() {
+    if (!hotReload) return;
+    std::vector<std::string> changedFiles;
+    pollShaderWatcher(shaderWatcher, changedFiles);
+    if (changedFiles.empty()) return;
+    std::chrono::steady_clock::time_point editTime = std::chrono::steady_clock::now();
+
+    for (ShaderRecord& record : shaderRecords) {
+        bool affected = false;
+        for (const std::string& file : changedFiles) {
+            affected = affected || std::find(record.files.begin(), record.files.end(), file) != record.files.end();
+        }
+        if (!affected) continue;
+
+        // A newer edit supersedes a reload still building; a program that
+        // was never ready is simply built again from scratch
+        bool ready = record.program->ready;
+        cancelBuilds(*record.program);
+        if (!ready) glDeleteProgram(record.program->id);
+        startBuild(record, ready ? record.program : NULL, editTime);
+    }
+}
+
+void stopShaderHotReload() {
+    if (!hotReload) return;
+    closeShaderWatcher(shaderWatcher);
+    hotReload = false;
+}
+
+void setShaderReloadCallback(const std::function<void(const ShaderProgram&)>& callback) {
+    reloadCallback = callback;
+}
+
+void initShaderVariants(ShaderVariantCache& cache, const char* vertexPath, const char* fragmentPath,
+                        int materialBinding, size_t capacity) {
+    cache.vertexPath = vertexPath;
+    cache.fragmentPath = fragmentPath;
+    cache.materialBinding = materialBinding;
+    cache.capacity = std::max<size_t>(capacity, 1);
+}
+
+const ShaderProgram* findShaderVariant(ShaderVariantCache& cache, const ShaderDefines& defines) {
+    std::string key;
+    for (const ShaderDefine& define : defines) {
+        key += define.name + "=" + define.value + ";";
+    }
+
+    std::list<ShaderVariant>::iterator variant = cache.variants.begin();
+    while (variant != cache.variants.end() && variant->key != key) ++variant;
+    if (variant != cache.variants.end()) {
+        cache.variants.splice(cache.variants.begin(), cache.variants, variant);
+    } else {
+        if (cache.variants.size() == cache.capacity) {
+            deleteShader(cache.variants.back().program);
+            cache.variants.pop_back();
+        }
+        cache.variants.push_front(ShaderVariant());
+        cache.variants.front().key = key;
+        createShader(cache.variants.front().program, cache.vertexPath.c_str(), cache.fragmentPath.c_str(),
+                     cache.materialBinding, defines);
+        frameStats.shaderVariantBuilds++;
+    }
+
+    const ShaderProgram& program = cache.variants.front().program;
+    return program.ready ? &program : NULL;
+}
+
+void deleteShaderVariants(ShaderVariantCache& cache) {
+    for (ShaderVariant& variant : cache.variants) {
+        deleteShader(variant.program);
+    }
+    cache.variants.clear();
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "ShaderPreprocessor.h"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <functional>
+#include <list>
+#include <string>
+
+// Camera and light data shared by every program, uploaded once per frame.
+// Mirrors the std140 FrameData block declared in the shaders; vec3 members
+// take a full 16-byte slot in std140, hence the vec4s.
+struct FrameData {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec4 viewPos;
+    glm::vec4 lightPos;
+};
+
+const unsigned int FRAME_DATA_BINDING = 0;
+
+// Each material owns a uniform buffer bound at MATERIAL_BINDING_BASE + its id
+const unsigned int MATERIAL_BINDING_BASE = 1;
+
+// Uniforms the render code sets by slot instead of by name. Locations are
+// looked up once, right after the program is linked; a slot the program does
+// not declare resolves to -1, which glUniform* silently ignores. The
+// FrameData block is bound to FRAME_DATA_BINDING at the same time.
+enum UniformSlot {
+    UNIFORM_MODEL,
+    UNIFORM_NORMAL_MATRIX,
+    UNIFORM_BAKED_NOISE,
+    UNIFORM_BAKED_MIN,
+    UNIFORM_BAKED_INV_SIZE,
+    UNIFORM_COUNT
+};
+
+// ready turns true once the program is linked (or failed to) and its
+// uniforms are resolved; until then it must not be drawn with.
+struct ShaderProgram {
+    unsigned int id = 0;
+    bool ready = false;
+    int materialBinding = -1;   // Binding point of its Material block, if it has one
+    GLint uniforms[UNIFORM_COUNT];
+};
+
+// How the programs created so far were obtained. createShader first tries a
+// program binary cached on disk by an earlier run; if there is none, or the
+// driver rejects it, the program is compiled and its binary saved.
+struct ProgramCacheStats {
+    int compiled = 0;   // Counted when submitted
+    int loaded = 0;     // From the binary cache
+    int rejected = 0;   // Cached binaries the driver refused, then compiled
+};
+
+extern ProgramCacheStats programCacheStats;
+
+// Shaders come from the tables tools/EmbedShaders generates at build time;
+// paths are looked up by what follows their last "shaders/". With files
+// from disk turned on they are read from the paths as given, so edits show
+// up without a rebuild.
+void setShaderFilesFromDisk(bool fromDisk);
+std::string readShaderFile(const char* filePath);
+
+// Starts building a program into the given ShaderProgram, which has to stay
+// where it is until it is ready. Compiles and links are only submitted here;
+// pollShaders() moves them along without blocking where the driver supports
+// KHR_parallel_shader_compile, and logs each program's compile and link time
+// and errors as it finishes. The Material block, when materialBinding is not
+// -1, is bound along with FrameData. defines specialise the program (see
+// ShaderVariantCache).
+void createShader(ShaderProgram& program, const char* vertexPath, const char* fragmentPath, int materialBinding = -1,
+                  const ShaderDefines& defines = ShaderDefines());
+// Returns how many programs are still building
+int pollShaders();
+void waitForShader(const ShaderProgram& program);
+void waitForShaders();
+void resolveUniforms(ShaderProgram& program);
+void bindUniformBlock(const ShaderProgram& program, const char* blockName, unsigned int binding);
+void deleteShader(ShaderProgram& program);
+
+// Hot reload, for shader development with files from disk: programs using a
+// file that changes under shaderDirectory are rebuilt through the same
+// pipeline as createShader and, once linked, pollShaders() swaps the new
+// program object into the ShaderProgram, so a frame draws with one or the
+// other. A program that fails to compile or link keeps the old one. Each
+// swap logs how long after the edit it happened.
+bool startShaderHotReload(const char* shaderDirectory);
+// Once per frame, before pollShaders()
+void reloadChangedShaders();
+void stopShaderHotReload();
+// Runs after a reload is swapped in, for uniforms that are set once rather
+// than per draw
+void setShaderReloadCallback(const std::function<void(const ShaderProgram&)>& callback);
+
+// Specialisations of one program, each built with its own set of #defines
+// the first time it is asked for, so values that would otherwise be
+// uniforms (an octave count, say) become constants the compiler can unroll.
+// The most recently used capacity variants are kept; the least recently used
+// one is deleted to make room.
+struct ShaderVariant {
+    std::string key;
+    ShaderProgram program;
+};
+
+struct ShaderVariantCache {
+    std::string vertexPath;
+    std::string fragmentPath;
+    int materialBinding = -1;
+    size_t capacity = 4;
+    std::list<ShaderVariant> variants;   // Most recent first; nodes stay put while their program builds
+};
+
+void initShaderVariants(ShaderVariantCache& cache, const char* vertexPath, const char* fragmentPath,
+                        int materialBinding, size_t capacity);
+// Starts the variant's build on first use; NULL until it is ready
+const ShaderProgram* findShaderVariant(ShaderVariantCache& cache, const ShaderDefines& defines);
+void deleteShaderVariants(ShaderVariantCache& cache);
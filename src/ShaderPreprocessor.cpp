@@ -0,0 +1,261 @@
+#include "ShaderPreprocessor.h"
+#include "Shader.h"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+struct Preprocessor {
+    std::string directory;
+    ShaderSource* source;
+    const ShaderDefines* defines;
+    // [begin, end) of code that came from included files; only functions in
+    // these ranges are candidates for stripping
+    std::vector<std::pair<size_t, size_t>> includedRanges;
+    bool ok = true;
+};
+
+static bool parseInclude(const std::string& line, std::string& name) {
+    size_t i = line.find_first_not_of(" \t");
+    if (i == std::string::npos || line[i] != '#') return false;
+    i = line.find_first_not_of(" \t", i + 1);
+    if (i == std::string::npos || line.compare(i, 7, "include") != 0) return false;
+    size_t open = line.find('"', i + 7);
+    size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+    if (close == std::string::npos) return false;
+    name = line.substr(open + 1, close - open - 1);
+    return true;
+}
+
+// Lines of file k are numbered from k * SOURCE_LINE_STRIDE + 1, on top of
+// source string k: Mesa only reports the source string number for
+// preprocessor errors, the line number always comes through.
+static const int SOURCE_LINE_STRIDE = 100000;
+
+// The line after "#line N S" is line N of source string S (as drivers
+// implement it, whatever the GLSL version)
+static std::string lineDirective(int line, int sourceIndex) {
+    int nextLine = sourceIndex * SOURCE_LINE_STRIDE + line;
+    return "#line " + std::to_string(nextLine) + " " + std::to_string(sourceIndex) + "\n";
+}
+
+static void expandFile(Preprocessor& state, const std::string& text, int fileIndex) {
+    std::string& code = state.source->code;
+    std::vector<std::string>& files = state.source->files;
+
+    size_t rangeBegin = code.size();
+    std::istringstream lines(text);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(lines, line)) {
+        lineNumber++;
+        std::string name;
+        if (!parseInclude(line, name)) {
+            code += line;
+            code += '\n';
+            if (fileIndex == 0 && lineNumber == 1 && line.compare(0, 8, "#version") == 0 && !state.defines->empty()) {
+                for (const ShaderDefine& define : *state.defines) {
+                    code += "#define " + define.name + " " + define.value + "\n";
+                }
+                code += lineDirective(2, 0);
+            }
+            continue;
+        }
+
+        if (fileIndex > 0) state.includedRanges.push_back(std::make_pair(rangeBegin, code.size()));
+        if (std::find(files.begin(), files.end(), name) != files.end()) {
+            // Already in, the blank line keeps the numbering
+            code += '\n';
+        } else {
+            std::string included = readShaderFile((state.directory + name).c_str());
+            if (included.empty()) {
+                std::cout << "ERROR::SHADER::INCLUDE_FAILED: " << name << " (included from " << files[fileIndex]
+                          << ":" << lineNumber << ")" << std::endl;
+                state.ok = false;
+                code += '\n';
+            } else {
+                int index = (int)files.size();
+                files.push_back(name);
+                code += lineDirective(1, index);
+                expandFile(state, included, index);
+                code += lineDirective(lineNumber + 1, fileIndex);
+            }
+        }
+        rangeBegin = code.size();
+    }
+    if (fileIndex > 0) state.includedRanges.push_back(std::make_pair(rangeBegin, code.size()));
+}
+
+struct FunctionSpan {
+    size_t begin;
+    size_t end;
+    std::string name;
+    bool kept;
+};
+
+static bool isIdentifierChar(char c) {
+    return std::isalnum((unsigned char)c) || c == '_';
+}
+
+// Skips the comment starting at i, if there is one; returns where scanning
+// should continue
+static size_t skipComment(const std::string& code, size_t i, size_t end) {
+    if (i + 1 >= end || code[i] != '/') return i;
+    if (code[i + 1] == '/') {
+        size_t newline = code.find('\n', i);
+        return newline == std::string::npos || newline > end ? end : newline;
+    }
+    if (code[i + 1] == '*') {
+        size_t close = code.find("*/", i + 2);
+        return close == std::string::npos || close + 2 > end ? end : close + 2;
+    }
+    return i;
+}
+
+// Splits code[begin, end) into top-level items and records the function
+// definitions: items whose text before the opening brace ends in ")". A
+// span starts right after the previous item, so the comment above a
+// function goes with it.
+static void findFunctions(const std::string& code, size_t begin, size_t end, std::vector<FunctionSpan>& functions) {
+    size_t itemBegin = begin;
+    size_t firstBrace = std::string::npos;
+    int depth = 0;
+    bool lineStart = true;
+    for (size_t i = begin; i < end; i++) {
+        size_t skipped = skipComment(code, i, end);
+        if (skipped != i) {
+            i = skipped - 1;
+            continue;
+        }
+        char c = code[i];
+        if (c == '#' && lineStart && depth == 0) {
+            // Directives stand alone between items
+            size_t newline = code.find('\n', i);
+            i = newline == std::string::npos || newline > end ? end : newline;
+            itemBegin = i;
+            lineStart = true;
+            continue;
+        }
+        if (c == '\n') lineStart = true;
+        else if (c != ' ' && c != '\t') lineStart = false;
+
+        if (c == '{') {
+            if (depth == 0) firstBrace = i;
+            depth++;
+        } else if (c == '}' && depth > 0 && --depth == 0) {
+            size_t header = code.find_last_not_of(" \t\n", firstBrace - 1);
+            if (header != std::string::npos && header >= itemBegin && header < firstBrace && code[header] == ')') {
+                size_t open = code.rfind('(', header);
+                size_t nameEnd = code.find_last_not_of(" \t", open - 1) + 1;
+                size_t nameBegin = nameEnd;
+                while (nameBegin > itemBegin && isIdentifierChar(code[nameBegin - 1])) nameBegin--;
+                FunctionSpan span = {itemBegin, i + 1, code.substr(nameBegin, nameEnd - nameBegin), false};
+                functions.push_back(span);
+            }
+            itemBegin = i + 1;
+        } else if (c == ';' && depth == 0) {
+            itemBegin = i + 1;
+        }
+    }
+}
+
+static void collectIdentifiers(const std::string& code, size_t begin, size_t end, std::set<std::string>& names) {
+    for (size_t i = begin; i < end; i++) {
+        size_t skipped = skipComment(code, i, end);
+        if (skipped != i) {
+            i = skipped - 1;
+            continue;
+        }
+        if (!isIdentifierChar(code[i]) || std::isdigit((unsigned char)code[i])) continue;
+        size_t nameEnd = i;
+        while (nameEnd < end && isIdentifierChar(code[nameEnd])) nameEnd++;
+        names.insert(code.substr(i, nameEnd - i));
+        i = nameEnd - 1;
+    }
+}
+
+// Keeps the included functions reachable from code outside them (main, in
+// the end) and blanks the rest out, newlines excepted
+static void stripUnusedFunctions(Preprocessor& state) {
+    std::string& code = state.source->code;
+    std::vector<FunctionSpan> functions;
+    for (const std::pair<size_t, size_t>& range : state.includedRanges) {
+        findFunctions(code, range.first, range.second, functions);
+    }
+    if (functions.empty()) return;
+
+    std::set<std::string> used;
+    used.insert("main");
+    size_t outside = 0;
+    for (const FunctionSpan& function : functions) {
+        collectIdentifiers(code, outside, function.begin, used);
+        outside = function.end;
+    }
+    collectIdentifiers(code, outside, code.size(), used);
+
+    // Overloads share a name and are kept or dropped together
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (FunctionSpan& function : functions) {
+            if (function.kept || used.count(function.name) == 0) continue;
+            function.kept = true;
+            collectIdentifiers(code, function.begin, function.end, used);
+            changed = true;
+        }
+    }
+
+    for (size_t i = functions.size(); i-- > 0;) {
+        const FunctionSpan& function = functions[i];
+        if (function.kept) continue;
+        std::string newlines(std::count(code.begin() + function.begin, code.begin() + function.end, '\n'), '\n');
+        code.replace(function.begin, function.end - function.begin, newlines);
+    }
+}
+
+bool preprocessShader(const std::string& path, ShaderSource& source, const ShaderDefines& defines) {
+    source.code.clear();
+    source.files.assign(1, path);
+
+    std::string text = readShaderFile(path.c_str());
+    if (text.empty()) return false;
+
+    Preprocessor state;
+    size_t slash = path.find_last_of("/\\");
+    state.directory = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+    state.source = &source;
+    state.defines = &defines;
+    expandFile(state, text, 0);
+    stripUnusedFunctions(state);
+    return state.ok;
+}
+
+std::string mapSourceNames(const std::string& log, const ShaderSource& source) {
+    std::istringstream lines(log);
+    std::string line;
+    std::string mapped;
+    while (std::getline(lines, line)) {
+        // Mesa writes "0:12(5): error", NVIDIA "0(12) : error", AMD
+        // "ERROR: 0:12: ..."
+        size_t begin = 0;
+        if (line.compare(0, 7, "ERROR: ") == 0) begin = 7;
+        else if (line.compare(0, 9, "WARNING: ") == 0) begin = 9;
+        size_t separator = begin;
+        while (separator < line.size() && std::isdigit((unsigned char)line[separator])) separator++;
+        size_t end = separator + 1;
+        while (end < line.size() && std::isdigit((unsigned char)line[end])) end++;
+        if (separator > begin && end > separator + 1 && (line[separator] == ':' || line[separator] == '(')) {
+            unsigned long lineNumber = std::stoul(line.substr(separator + 1, end - separator - 1));
+            size_t index = lineNumber / SOURCE_LINE_STRIDE;
+            if (index < source.files.size()) {
+                std::string location = source.files[index] + line[separator]
+                                     + std::to_string(lineNumber % SOURCE_LINE_STRIDE);
+                line.replace(begin, end - begin, location);
+            }
+        }
+        mapped += line;
+        mapped += '\n';
+    }
+    return mapped;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Constants a shader is specialised with, written as #define NAME VALUE
+// right after its #version line
+struct ShaderDefine {
+    std::string name;
+    std::string value;
+};
+
+typedef std::vector<ShaderDefine> ShaderDefines;
+
+// A shader stage after its #include "file" directives are resolved. Include
+// paths are relative to the directory of the top-level shader, also from
+// nested includes, and each file goes in at most once. Functions that came
+// from an include and that nothing in the stage calls are dropped, so a
+// program only compiles the part of the noise library it uses.
+//
+// Every file gets its own GLSL source string number, its index in files,
+// and its own range of line numbers through #line directives; dropped
+// functions leave their newlines behind so the numbering holds.
+struct ShaderSource {
+    std::string code;
+    std::vector<std::string> files;   // [0] is the top-level shader
+};
+
+// Returns false, after printing what is missing, when the shader or one of
+// its includes cannot be read
+bool preprocessShader(const std::string& path, ShaderSource& source,
+                      const ShaderDefines& defines = ShaderDefines());
+
+// Rewrites the "N:line" / "N(line)" locations at the start of each line of a
+// compile log into file name and line
+std::string mapSourceNames(const std::string& log, const ShaderSource& source);
@@ -0,0 +1,115 @@
+#include "ShaderWatcher.h"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+static bool isShaderFile(const std::string& name) {
+    return name.size() > 5 && name.compare(name.size() - 5, 5, ".glsl") == 0;
+}
+
+static void addChange(std::vector<std::string>& changedFiles, const std::string& name) {
+    if (std::find(changedFiles.begin(), changedFiles.end(), name) == changedFiles.end()) {
+        changedFiles.push_back(name);
+    }
+}
+
+#ifdef __linux__
+static bool addWatch(ShaderWatcher& watcher, const std::string& subdirectory) {
+    std::string path = subdirectory.empty() ? watcher.directory : watcher.directory + "/" + subdirectory;
+    int watch = inotify_add_watch(watcher.fd, path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (watch < 0) {
+        std::cout << "ERROR::SHADER_WATCHER::CANNOT_WATCH: " << path << std::endl;
+        return false;
+    }
+    watcher.watches[watch] = subdirectory;
+    return true;
+}
+
+bool openShaderWatcher(ShaderWatcher& watcher, const std::string& directory) {
+    watcher.directory = directory;
+    watcher.fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (watcher.fd < 0) {
+        std::cout << "ERROR::SHADER_WATCHER::INOTIFY_UNAVAILABLE" << std::endl;
+        return false;
+    }
+
+    bool ok = addWatch(watcher, "");
+    std::error_code error;
+    for (fs::recursive_directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+        if (it->is_directory()) {
+            ok = addWatch(watcher, it->path().lexically_relative(directory).generic_string()) && ok;
+        }
+    }
+    return ok;
+}
+
+void pollShaderWatcher(ShaderWatcher& watcher, std::vector<std::string>& changedFiles) {
+    if (watcher.fd < 0) return;
+    alignas(inotify_event) char buffer[4096];
+    ssize_t length;
+    while ((length = read(watcher.fd, buffer, sizeof(buffer))) > 0) {
+        for (char* next = buffer; next < buffer + length;) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(next);
+            next += sizeof(inotify_event) + event->len;
+            std::map<int, std::string>::const_iterator watch = watcher.watches.find(event->wd);
+            if (event->len == 0 || watch == watcher.watches.end() || !isShaderFile(event->name)) continue;
+            addChange(changedFiles, watch->second.empty() ? event->name : watch->second + "/" + event->name);
+        }
+    }
+}
+
+void closeShaderWatcher(ShaderWatcher& watcher) {
+    if (watcher.fd >= 0) close(watcher.fd);
+    watcher.fd = -1;
+    watcher.watches.clear();
+}
+#else
+// Calls back with every shader file and its modification time
+template <typename Visit>
+static void scanShaderFiles(const std::string& directory, Visit visit) {
+    std::error_code error;
+    for (fs::recursive_directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+        std::string name = it->path().lexically_relative(directory).generic_string();
+        if (!it->is_regular_file() || !isShaderFile(name)) continue;
+        fs::file_time_type writeTime = fs::last_write_time(it->path(), error);
+        if (!error) visit(name, (long long)writeTime.time_since_epoch().count());
+        error.clear();
+    }
+}
+
+bool openShaderWatcher(ShaderWatcher& watcher, const std::string& directory) {
+    watcher.directory = directory;
+    watcher.lastScan = std::chrono::steady_clock::now();
+    scanShaderFiles(directory, [&](const std::string& name, long long writeTime) {
+        watcher.writeTimes[name] = writeTime;
+    });
+    if (watcher.writeTimes.empty()) {
+        std::cout << "ERROR::SHADER_WATCHER::NO_SHADERS: " << directory << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void pollShaderWatcher(ShaderWatcher& watcher, std::vector<std::string>& changedFiles) {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now - watcher.lastScan < std::chrono::milliseconds(SHADER_WATCH_SCAN_MS)) return;
+    watcher.lastScan = now;
+    scanShaderFiles(watcher.directory, [&](const std::string& name, long long writeTime) {
+        long long& known = watcher.writeTimes[name];
+        if (known != writeTime) {
+            known = writeTime;
+            addChange(changedFiles, name);
+        }
+    });
+}
+
+void closeShaderWatcher(ShaderWatcher& watcher) {
+    watcher.writeTimes.clear();
+}
+#endif
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+// Reports shader files written under a directory, for hot reload. On Linux
+// it reads inotify events (close after write, or a rename into place as
+// most editors save) for the directory and its subdirectories; elsewhere it
+// compares modification times, at most every SHADER_WATCH_SCAN_MS.
+const int SHADER_WATCH_SCAN_MS = 250;
+
+struct ShaderWatcher {
+    std::string directory;
+#ifdef __linux__
+    int fd = -1;
+    std::map<int, std::string> watches;     // Watch descriptor -> subdirectory ("" for the root)
+#else
+    std::map<std::string, long long> writeTimes;
+    std::chrono::steady_clock::time_point lastScan;
+#endif
+};
+
+bool openShaderWatcher(ShaderWatcher& watcher, const std::string& directory);
+// Never blocks. Appends the .glsl files written since the last call, relative
+// to the directory with '/' separators, each once.
+void pollShaderWatcher(ShaderWatcher& watcher, std::vector<std::string>& changedFiles);
+void closeShaderWatcher(ShaderWatcher& watcher);
@@ -0,0 +1,58 @@
+#include "Transforms.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+const Transform IDENTITY_TRANSFORM = {glm::mat4(1.0f), glm::mat3(1.0f)};
+
+static Transform& transformAt(Transform* transforms, size_t index, size_t stride) {
+    return *reinterpret_cast<Transform*>(reinterpret_cast<char*>(transforms) + index * stride);
+}
+
+// The inverse transpose is the cofactor matrix over the determinant. For
+// columns a, b, c the cofactor columns are b x c, c x a and a x b, and the
+// determinant is a . (b x c).
+#ifdef __SSE2__
+// (x, y, z, w) -> (y, z, x, w)
+static inline __m128 yzx(__m128 v) {
+    return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 2, 1));
+}
+
+static inline __m128 cross(__m128 a, __m128 b) {
+    return yzx(_mm_sub_ps(_mm_mul_ps(a, yzx(b)), _mm_mul_ps(yzx(a), b)));
+}
+
+// One column per register; the w lanes are ignored
+static inline void updateNormalMatrix(Transform& transform) {
+    __m128 a = _mm_loadu_ps(&transform.model[0][0]);
+    __m128 b = _mm_loadu_ps(&transform.model[1][0]);
+    __m128 c = _mm_loadu_ps(&transform.model[2][0]);
+    __m128 bc = cross(b, c), ca = cross(c, a), ab = cross(a, b);
+
+    __m128 products = _mm_mul_ps(a, bc);
+    __m128 det = _mm_add_ss(_mm_add_ss(products, _mm_shuffle_ps(products, products, _MM_SHUFFLE(1, 1, 1, 1))),
+                            _mm_movehl_ps(products, products));
+    __m128 invDet = _mm_div_ps(_mm_set1_ps(1.0f), _mm_shuffle_ps(det, det, 0));
+
+    // The first two stores run a float into the next column, which is
+    // written after them; the last one stops at the end of the matrix
+    float* out = &transform.normalMatrix[0][0];
+    _mm_storeu_ps(out, _mm_mul_ps(bc, invDet));
+    _mm_storeu_ps(out + 3, _mm_mul_ps(ca, invDet));
+    __m128 last = _mm_mul_ps(ab, invDet);
+    _mm_storel_pi(reinterpret_cast<__m64*>(out + 6), last);
+    _mm_store_ss(out + 8, _mm_movehl_ps(last, last));
+}
+#else
+static void updateNormalMatrix(Transform& transform) {
+    glm::vec3 a(transform.model[0]), b(transform.model[1]), c(transform.model[2]);
+    glm::vec3 bc = glm::cross(b, c);
+    transform.normalMatrix = glm::mat3(bc, glm::cross(c, a), glm::cross(a, b)) * (1.0f / glm::dot(a, bc));
+}
+#endif
+
+void updateNormalMatrices(Transform* transforms, size_t count, size_t stride) {
+    for (size_t i = 0; i < count; i++) {
+        updateNormalMatrix(transformAt(transforms, i, stride));
+    }
+}
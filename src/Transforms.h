@@ -0,0 +1,19 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+
+// A model matrix with its normal matrix, the inverse transpose of its upper
+// 3x3. Both are computed on the CPU when the model changes and sent to the
+// vertex shaders, which then only multiply.
+struct Transform {
+    glm::mat4 model;
+    glm::mat3 normalMatrix;
+};
+
+extern const Transform IDENTITY_TRANSFORM;
+
+// Recomputes normalMatrix from model for count transforms laid out stride
+// bytes apart, so transforms embedded in larger structs (instances) can be
+// updated in place. Uses SSE where the target has it.
+void updateNormalMatrices(Transform* transforms, size_t count, size_t stride = sizeof(Transform));
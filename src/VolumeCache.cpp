@@ -0,0 +1,202 @@
+#include "VolumeCache.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+static const char VOLUME_CACHE_MAGIC[4] = {'R', 'V', 'O', 'L'};
+static_assert(sizeof(VolumeCacheHeader) == 72, "cache file layout changed, bump VOLUME_CACHE_VERSION");
+
+static GLenum voxelFormat(int channels) {
+    return channels == 1 ? GL_R16F : GL_RG16F;
+}
+
+static fs::path entryPath(const VolumeCache& cache, const char* materialName, uint64_t key) {
+    char name[64];
+    std::snprintf(name, sizeof(name), "%s_%016llx.vol", materialName, (unsigned long long)key);
+    return fs::path(cache.directory) / name;
+}
+
+bool openVolumeCache(VolumeCache& cache, const std::string& directory, uint64_t maxBytes) {
+    cache.directory = directory;
+    cache.maxBytes = maxBytes;
+    std::error_code error;
+    fs::create_directories(directory, error);
+    if (error) {
+        std::cout << "ERROR::VOLUME_CACHE::CANNOT_CREATE_DIRECTORY: " << directory << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool mapFile(const fs::path& path, MappedVolume& out) {
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size;
+    HANDLE mapping = GetFileSizeEx(file, &size) && size.QuadPart > 0
+                   ? CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    out.file = file;
+    out.mapping = mapping;
+    out.view = view;
+    out.length = (size_t)size.QuadPart;
+#else
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0) return false;
+    struct stat info;
+    void* view = MAP_FAILED;
+    if (fstat(file, &info) == 0 && info.st_size > 0) {
+        view = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    }
+    close(file);    // The mapping keeps the file alive
+    if (view == MAP_FAILED) return false;
+    out.view = view;
+    out.length = (size_t)info.st_size;
+#endif
+    return true;
+}
+
+void unmapCachedVolume(MappedVolume& volume) {
+    if (!volume.view) return;
+#ifdef _WIN32
+    UnmapViewOfFile(volume.view);
+    CloseHandle(volume.mapping);
+    CloseHandle(volume.file);
+    volume.file = NULL;
+    volume.mapping = NULL;
+#else
+    munmap(volume.view, volume.length);
+#endif
+    volume.view = NULL;
+    volume.length = 0;
+}
+
+bool mapCachedVolume(const VolumeCache& cache, const char* materialName, uint32_t materialId, uint64_t key,
+                     MappedVolume& out) {
+    fs::path path = entryPath(cache, materialName, key);
+    if (!mapFile(path, out)) {
+        return false;
+    }
+
+    const VolumeCacheHeader* header = static_cast<const VolumeCacheHeader*>(out.view);
+    bool valid = out.length >= sizeof(VolumeCacheHeader)
+              && std::memcmp(header->magic, VOLUME_CACHE_MAGIC, 4) == 0
+              && header->version == VOLUME_CACHE_VERSION
+              && header->materialId == materialId
+              && header->key == key
+              && header->channels >= 1 && header->channels <= BAKE_MAX_CHANNELS
+              && header->format == voxelFormat(header->channels)
+              && header->dataBytes == (uint64_t)header->size[0] * header->size[1] * header->size[2]
+                                      * header->channels * sizeof(uint16_t)
+              && out.length == sizeof(VolumeCacheHeader) + header->dataBytes;
+    if (!valid) {
+        // Written by another version, or damaged: bake again
+        unmapCachedVolume(out);
+        std::error_code error;
+        fs::remove(path, error);
+        return false;
+    }
+
+    out.data.key = header->key;
+    out.data.bounds.min = glm::vec3(header->boundsMin[0], header->boundsMin[1], header->boundsMin[2]);
+    out.data.bounds.max = glm::vec3(header->boundsMax[0], header->boundsMax[1], header->boundsMax[2]);
+    out.data.size = glm::ivec3(header->size[0], header->size[1], header->size[2]);
+    out.data.channels = header->channels;
+    out.data.voxels = reinterpret_cast<const uint16_t*>(header + 1);
+
+    // A hit makes the entry the most recently used one
+    std::error_code error;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), error);
+    return true;
+}
+
+static void evictVolumes(const VolumeCache& cache) {
+    struct Entry {
+        fs::path path;
+        uint64_t bytes;
+        fs::file_time_type used;
+    };
+    std::vector<Entry> entries;
+    uint64_t total = 0;
+
+    std::error_code error;
+    for (fs::directory_iterator it(cache.directory, error), end; !error && it != end; it.increment(error)) {
+        if (it->path().extension() != ".vol") continue;
+        Entry entry;
+        entry.path = it->path();
+        entry.bytes = it->file_size(error);
+        entry.used = it->last_write_time(error);
+        if (error) {
+            error.clear();
+            continue;
+        }
+        entries.push_back(entry);
+        total += entry.bytes;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.used < b.used; });
+    for (const Entry& entry : entries) {
+        if (total <= cache.maxBytes) break;
+        // Another writer may have got there first; either way it is gone
+        fs::remove(entry.path, error);
+        total -= entry.bytes;
+    }
+}
+
+void writeCachedVolume(const VolumeCache& cache, const char* materialName, uint32_t materialId,
+                       const VolumeData& data) {
+    VolumeCacheHeader header = {};
+    std::memcpy(header.magic, VOLUME_CACHE_MAGIC, 4);
+    header.version = VOLUME_CACHE_VERSION;
+    header.materialId = materialId;
+    header.format = voxelFormat(data.channels);
+    header.key = data.key;
+    for (int i = 0; i < 3; i++) {
+        header.size[i] = data.size[i];
+        header.boundsMin[i] = data.bounds.min[i];
+        header.boundsMax[i] = data.bounds.max[i];
+    }
+    header.channels = data.channels;
+    header.dataBytes = (uint64_t)data.size.x * data.size.y * data.size.z * data.channels * sizeof(uint16_t);
+
+    fs::path path = entryPath(cache, materialName, data.key);
+    fs::path temporary = path;
+    temporary += ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(data.voxels), (std::streamsize)header.dataBytes);
+        if (!out) {
+            std::cout << "ERROR::VOLUME_CACHE::CANNOT_WRITE: " << temporary.string() << std::endl;
+            return;
+        }
+    }
+    std::error_code error;
+    fs::rename(temporary, path, error);
+    if (error) {
+        fs::remove(temporary, error);
+        return;
+    }
+
+    evictVolumes(cache);
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Bake.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Baked volumes kept on disk between runs, one file per material and
+// parameter key, named <material>_<key>.vol. A file is the header below
+// followed directly by the half-float voxels, so it is memory-mapped and
+// handed to the upload as is. Opening an entry checks it against what is
+// asked for (version, material, key, texel format, size) and deletes it on
+// any mismatch. The directory is kept under maxBytes by evicting the least
+// recently used entries, going by modification time, which a hit refreshes.
+const uint32_t VOLUME_CACHE_VERSION = 1;
+
+struct VolumeCacheHeader {
+    char magic[4];          // "RVOL"
+    uint32_t version;
+    uint32_t materialId;
+    uint32_t format;        // GL internal format of the voxels
+    uint64_t key;
+    int32_t size[3];
+    int32_t channels;
+    float boundsMin[3];
+    float boundsMax[3];
+    uint64_t dataBytes;
+};
+
+struct VolumeCache {
+    std::string directory;
+    uint64_t maxBytes;
+};
+
+// A mapped cache entry; data points into the mapping
+struct MappedVolume {
+    VolumeData data;
+    void* view = NULL;
+    size_t length = 0;
+#ifdef _WIN32
+    void* file = NULL;
+    void* mapping = NULL;
+#endif
+};
+
+// Creates the directory if needed
+bool openVolumeCache(VolumeCache& cache, const std::string& directory, uint64_t maxBytes);
+
+bool mapCachedVolume(const VolumeCache& cache, const char* materialName, uint32_t materialId, uint64_t key,
+                     MappedVolume& out);
+void unmapCachedVolume(MappedVolume& volume);
+
+// Writes through a temporary file and a rename, so readers never see a
+// partial entry, then evicts down to the size limit. Safe to call from jobs.
+void writeCachedVolume(const VolumeCache& cache, const char* materialName, uint32_t materialId,
+                       const VolumeData& data);
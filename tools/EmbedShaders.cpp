@@ -0,0 +1,170 @@
+// Build step: turns every .glsl file under a shader directory into constexpr
+// string tables that Shader.cpp compiles in, so the program reads no shader
+// files at startup.
+//
+//     EmbedShaders <shader directory> <output .inl>
+//
+// Files are split into snippets at blank lines (roughly one declaration or
+// function each) and every distinct snippet is stored once; a file is the
+// run of snippet indices that rebuilds it byte for byte. The output is only
+// rewritten when it changes.
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+struct ShaderFile {
+    std::string name;           // relative to the shader directory, '/' separated
+    std::vector<int> snippets;
+};
+
+static std::vector<std::string> splitSnippets(const std::string& text) {
+    std::vector<std::string> snippets;
+    size_t begin = 0;
+    while (begin < text.size()) {
+        size_t end = text.find("\n\n", begin);
+        end = end == std::string::npos ? text.size() : end + 2;
+        // A run of blank lines stays with the snippet before it
+        while (end < text.size() && text[end] == '\n') end++;
+        snippets.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+    return snippets;
+}
+
+// One C string literal per source line, so the generated file stays readable
+static void writeLiteral(std::ostream& out, const std::string& text) {
+    out << "    \"";
+    for (size_t i = 0; i < text.size(); i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (c == '\n') {
+            out << "\\n\"";
+            if (i + 1 < text.size()) out << "\n    \"";
+            continue;
+        }
+        if (c == '\\' || c == '"') {
+            out << '\\' << c;
+        } else if (c == '\t') {
+            out << "\\t";
+        } else if (c < 0x20 || c >= 0x7f) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\%03o", c);
+            out << escaped;
+        } else {
+            out << c;
+        }
+    }
+    if (text.empty() || text.back() != '\n') out << '"';
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cout << "Usage: EmbedShaders <shader directory> <output file>" << std::endl;
+        return 1;
+    }
+    fs::path directory = argv[1];
+
+    std::vector<fs::path> paths;
+    std::error_code error;
+    for (fs::recursive_directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+        if (it->is_regular_file() && it->path().extension() == ".glsl") paths.push_back(it->path());
+    }
+    if (error || paths.empty()) {
+        std::cout << "ERROR::EMBED_SHADERS::NO_SHADERS: " << directory.string() << std::endl;
+        return 1;
+    }
+
+    std::vector<ShaderFile> files;
+    std::vector<std::string> snippets;
+    std::map<std::string, int> snippetIndex;
+    size_t totalBytes = 0;
+    for (const fs::path& path : paths) {
+        std::ifstream in(path, std::ios::binary);
+        std::stringstream text;
+        text << in.rdbuf();
+        if (!in) {
+            std::cout << "ERROR::EMBED_SHADERS::FILE_NOT_SUCCESSFULLY_READ: " << path.string() << std::endl;
+            return 1;
+        }
+
+        ShaderFile file;
+        file.name = path.lexically_relative(directory).generic_string();
+        for (const std::string& snippet : splitSnippets(text.str())) {
+            std::map<std::string, int>::iterator found = snippetIndex.find(snippet);
+            if (found == snippetIndex.end()) {
+                found = snippetIndex.emplace(snippet, (int)snippets.size()).first;
+                snippets.push_back(snippet);
+            }
+            file.snippets.push_back(found->second);
+            totalBytes += snippet.size();
+        }
+        files.push_back(file);
+    }
+    std::sort(files.begin(), files.end(), [](const ShaderFile& a, const ShaderFile& b) {
+        return a.name < b.name;
+    });
+
+    size_t uniqueBytes = 0;
+    for (const std::string& snippet : snippets) uniqueBytes += snippet.size();
+
+    std::ostringstream out;
+    out << "// Generated by tools/EmbedShaders from shaders/, do not edit.\n";
+    out << "// " << files.size() << " files, " << snippets.size() << " distinct snippets, " << uniqueBytes
+        << " of " << totalBytes << " bytes kept after deduplication.\n\n";
+
+    out << "struct EmbeddedShaderFile {\n";
+    out << "    const char* name;\n";
+    out << "    unsigned short firstSnippet;   // into EMBEDDED_SHADER_FILE_SNIPPETS\n";
+    out << "    unsigned short snippetCount;\n";
+    out << "};\n\n";
+
+    out << "static constexpr const char* EMBEDDED_SHADER_SNIPPETS[] = {\n";
+    for (size_t i = 0; i < snippets.size(); i++) {
+        out << "    // " << i << "\n";
+        writeLiteral(out, snippets[i]);
+        out << ",\n";
+    }
+    out << "};\n\n";
+
+    out << "static constexpr unsigned short EMBEDDED_SHADER_FILE_SNIPPETS[] = {\n";
+    for (const ShaderFile& file : files) {
+        out << "    ";
+        for (size_t i = 0; i < file.snippets.size(); i++) {
+            out << file.snippets[i] << (i + 1 < file.snippets.size() ? ", " : ",");
+        }
+        out << "  // " << file.name << "\n";
+    }
+    out << "};\n\n";
+
+    out << "// Sorted by name\n";
+    out << "static constexpr EmbeddedShaderFile EMBEDDED_SHADER_FILES[] = {\n";
+    size_t first = 0;
+    for (const ShaderFile& file : files) {
+        out << "    {\"" << file.name << "\", " << first << ", " << file.snippets.size() << "},\n";
+        first += file.snippets.size();
+    }
+    out << "};\n";
+
+    std::string generated = out.str();
+    std::ifstream previous(argv[2], std::ios::binary);
+    std::stringstream previousText;
+    previousText << previous.rdbuf();
+    if (previous && previousText.str() == generated) return 0;
+
+    std::ofstream output(argv[2], std::ios::binary);
+    output << generated;
+    if (!output) {
+        std::cout << "ERROR::EMBED_SHADERS::CANNOT_WRITE_OUTPUT: " << argv[2] << std::endl;
+        return 1;
+    }
+    std::cout << "Embedded " << files.size() << " shader files, " << uniqueBytes << " of " << totalBytes
+              << " bytes after deduplication" << std::endl;
+    return 0;
+}